@@ -0,0 +1,185 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _DISCOVERY_ARENA_H_
+#define _DISCOVERY_ARENA_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace eprosima {
+namespace discovery_server {
+
+//! pool of small container nodes carved from large chunks, all chunks are released together with the arena
+class DiscoveryArena : public std::enable_shared_from_this<DiscoveryArena>
+{
+public:
+
+    //! process-wide allocation figures
+    struct Statistics
+    {
+        uint64_t nodes;     // nodes served by any arena
+        uint64_t chunks;    // chunks requested to the heap
+        uint64_t oversized; // requests forwarded to the heap
+    };
+
+    DiscoveryArena() = default;
+    ~DiscoveryArena();
+
+    DiscoveryArena(
+            const DiscoveryArena&) = delete;
+    DiscoveryArena& operator =(
+            const DiscoveryArena&) = delete;
+
+    void* allocate(
+            std::size_t bytes);
+
+    void deallocate(
+            void* p,
+            std::size_t bytes);
+
+    //! arena selected for the calling thread, the process default one if none
+    static std::shared_ptr<DiscoveryArena> current();
+
+    static Statistics statistics();
+
+    // node size granularity, also the guaranteed alignment
+    static const std::size_t granularity = 16;
+
+private:
+
+    static const std::size_t max_node_size = 512;
+    static const std::size_t chunk_size = 16384;
+
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+    std::mutex mutex_; // nodes may be released from any thread
+    std::array<FreeNode*, max_node_size / granularity> free_ {};
+    std::vector<void*> chunks_;
+    char* cursor_ = nullptr;
+    char* end_ = nullptr;
+
+    friend class ArenaScope;
+};
+
+//! selects the arena used by the allocators created on the calling thread while in scope
+class ArenaScope
+{
+    std::shared_ptr<DiscoveryArena> arena_;
+    DiscoveryArena* previous_;
+
+public:
+
+    explicit ArenaScope(
+            std::shared_ptr<DiscoveryArena> arena);
+    ~ArenaScope();
+
+    ArenaScope(
+            const ArenaScope&) = delete;
+    ArenaScope& operator =(
+            const ArenaScope&) = delete;
+};
+
+//! STL allocator over a DiscoveryArena, copied containers pick the arena in scope
+template<class T>
+class ArenaAllocator
+{
+    template<class U>
+    friend class ArenaAllocator;
+
+    std::shared_ptr<DiscoveryArena> arena_;
+
+    //! alignments beyond the arena granularity are not supported by the pool
+    static const bool pooled = alignof(T) <= DiscoveryArena::granularity;
+
+public:
+
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+    typedef std::false_type propagate_on_container_copy_assignment;
+
+    ArenaAllocator()
+        : arena_(DiscoveryArena::current())
+    {
+    }
+
+    template<class U>
+    ArenaAllocator(
+            const ArenaAllocator<U>& a)
+        : arena_(a.arena_)
+    {
+    }
+
+    T* allocate(
+            std::size_t n)
+    {
+        if (pooled)
+        {
+            return static_cast<T*>(arena_->allocate(n * sizeof(T)));
+        }
+
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(
+            T* p,
+            std::size_t n)
+    {
+        if (pooled)
+        {
+            arena_->deallocate(p, n * sizeof(T));
+        }
+        else
+        {
+            ::operator delete(p);
+        }
+    }
+
+    //! copies are kept on the arena of the copier
+    ArenaAllocator select_on_container_copy_construction() const
+    {
+        return ArenaAllocator();
+    }
+
+    template<class U>
+    bool operator ==(
+            const ArenaAllocator<U>& a) const
+    {
+        return arena_ == a.arena_;
+    }
+
+    template<class U>
+    bool operator !=(
+            const ArenaAllocator<U>& a) const
+    {
+        return arena_ != a.arena_;
+    }
+
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _DISCOVERY_ARENA_H_
@@ -0,0 +1,227 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _DISCOVERY_EVENT_QUEUE_H_
+#define _DISCOVERY_EVENT_QUEUE_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+#include "DiscoveryItem.h"
+#include "InternedString.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+//! discovery callback info, replayed later on a DiscoveryItemDatabase
+struct DiscoveryEvent
+{
+    enum class Kind : uint8_t
+    {
+        ADD_PARTICIPANT,
+        REMOVE_PARTICIPANT,
+        ADD_DATAREADER,
+        REMOVE_DATAREADER,
+        ADD_DATAWRITER,
+        REMOVE_DATAWRITER,
+        UPDATE_LIVELINESS
+    };
+
+    Kind kind = Kind::ADD_PARTICIPANT;
+    bool server = false;
+    int32_t alive_count = 0;
+    int32_t not_alive_count = 0;
+    GUID_t spokesman;
+    GUID_t participant;
+    GUID_t endpoint;
+    InternedString spokesman_name;
+    InternedString type_name;
+    InternedString topic_name;
+    std::string participant_name;
+    std::chrono::steady_clock::time_point timestamp;
+
+    // factories mirror the DiscoveryItemDatabase modifiers
+
+    static DiscoveryEvent AddParticipant(
+            const GUID_t& spokesman,
+            const InternedString& srcName,
+            const GUID_t& ptid,
+            std::string name,
+            const std::chrono::steady_clock::time_point& discovered_timestamp,
+            bool server);
+
+    static DiscoveryEvent RemoveParticipant(
+            const GUID_t& spokesman,
+            const GUID_t& ptid);
+
+    static DiscoveryEvent AddDataReader(
+            const GUID_t& spokesman,
+            const InternedString& srcName,
+            const GUID_t& ptid,
+            const GUID_t& sid,
+            const InternedString& _typename,
+            const InternedString& topicname,
+            const std::chrono::steady_clock::time_point& discovered_timestamp);
+
+    static DiscoveryEvent RemoveDataReader(
+            const GUID_t& spokesman,
+            const GUID_t& ptid,
+            const GUID_t& sid);
+
+    static DiscoveryEvent AddDataWriter(
+            const GUID_t& spokesman,
+            const InternedString& srcName,
+            const GUID_t& ptid,
+            const GUID_t& pid,
+            const InternedString& _typename,
+            const InternedString& topicname,
+            const std::chrono::steady_clock::time_point& discovered_timestamp);
+
+    static DiscoveryEvent RemoveDataWriter(
+            const GUID_t& spokesman,
+            const GUID_t& ptid,
+            const GUID_t& pid);
+
+    static DiscoveryEvent UpdateSubLiveliness(
+            const GUID_t& subs,
+            int32_t alive_count,
+            int32_t not_alive_count);
+
+    //! replays the event, returns the database modifier result. Owned strings are moved into the database
+    bool apply(
+            DiscoveryItemDatabase& database);
+};
+
+//! deferred application of discovery events on a DiscoveryItemDatabase
+class DiscoveryIngestion
+{
+public:
+
+    virtual ~DiscoveryIngestion() = default;
+
+    //! thread safe
+    virtual void push(
+            DiscoveryEvent&& event) = 0;
+
+    //! returns once all the events pushed before the call are applied
+    virtual void flush() = 0;
+
+    //! prints the ingestion counters
+    virtual void report(
+            std::ostream& os) const = 0;
+};
+
+std::ostream& operator <<(
+        std::ostream&,
+        const DiscoveryIngestion&);
+
+/**
+ * Bounded lock-free multi-producer queue of discovery events. A dedicated applier thread
+ * drains it in batches into a DiscoveryItemDatabase. Producers wait while the queue is full.
+ **/
+class DiscoveryEventQueue : public DiscoveryIngestion
+{
+public:
+
+    struct Statistics
+    {
+        uint64_t enqueued;     // events pushed
+        uint64_t applied;      // events replayed on the database
+        uint64_t depth;        // events pending
+        uint64_t max_depth;    // largest backlog found by the applier
+        uint64_t batches;      // batches replayed
+        uint64_t backpressure; // pushes that found the queue full
+    };
+
+    //! capacity is rounded up to a power of two
+    DiscoveryEventQueue(
+            DiscoveryItemDatabase& database,
+            std::size_t capacity = 16384);
+
+    //! applies all pending events before returning
+    ~DiscoveryEventQueue() override;
+
+    DiscoveryEventQueue(
+            const DiscoveryEventQueue&) = delete;
+    DiscoveryEventQueue& operator =(
+            const DiscoveryEventQueue&) = delete;
+
+    //! thread safe, waits if the queue is full
+    void push(
+            DiscoveryEvent&& event) override;
+
+    //! waits till all the events pushed before the call are applied, not to be called from the applier
+    void flush() override;
+
+    void report(
+            std::ostream& os) const override;
+
+    Statistics statistics() const;
+
+private:
+
+    struct Cell
+    {
+        std::atomic<uint64_t> sequence;
+        DiscoveryEvent event;
+    };
+
+    //! max events replayed before notifying flush waiters
+    static const std::size_t max_batch = 256;
+
+    DiscoveryItemDatabase& database_;
+    std::unique_ptr<Cell[]> cells_;
+    uint64_t mask_;
+
+    std::atomic<uint64_t> enqueue_pos_{0};
+
+    // applier wake up and flush synchronization, also keeps producer and applier positions apart
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::condition_variable applied_cv_;
+    std::atomic<bool> sleeping_{false};
+    bool stop_ = false;
+
+    uint64_t dequeue_pos_ = 0; // only accessed by the applier
+
+    // statistics
+    std::atomic<uint64_t> applied_{0};
+    std::atomic<uint64_t> max_depth_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<uint64_t> backpressure_{0};
+
+    std::thread applier_;
+
+    //! next event is published, applier only
+    bool ready() const;
+
+    //! applier only
+    bool pop(
+            DiscoveryEvent& event);
+
+    void run();
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _DISCOVERY_EVENT_QUEUE_H_
@@ -15,17 +15,32 @@
 #ifndef _DI_H_
 #define _DI_H_
 
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <chrono>
+#include <cstdint>
 #include <ctime>
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <ostream>
 #include <set>
+#include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <fastdds/rtps/common/Guid.hpp>
 
+#include "DiscoveryArena.h"
+#include "DiscoveryJournal.h"
+#include "DiscoveryNotifier.h"
+#include "InternedString.h"
+#include "PersistentSet.h"
+
 namespace tinyxml2 {
 class XMLElement;
 class XMLDocument;
@@ -36,6 +51,13 @@ namespace discovery_server {
 
 typedef fastdds::rtps::GUID_t GUID_t;
 
+//! hash functor that allows GUID_t keyed unordered containers
+struct GUIDHash
+{
+    std::size_t operator ()(
+            const GUID_t& guid) const;
+};
+
 struct TopicDescriptionItem
 {
     TopicDescriptionItem()
@@ -107,13 +129,18 @@ struct DiscoveryItem
             const DiscoveryItem&) const;
 };
 
+//! allows heterogeneous lookups (std::less<>) of items by GUID_t
+bool operator <(
+        const GUID_t&,
+        const DiscoveryItem&);
+
 //! publisher specific info
 struct DataWriterDiscoveryItem : public DiscoveryItem
 {
     DataWriterDiscoveryItem(
             const GUID_t& id,
-            const std::string& type,
-            const std::string& topic,
+            const InternedString& type,
+            const InternedString& topic,
             const std::chrono::steady_clock::time_point& discovered_timestamp)
         : DiscoveryItem(id)
         , type_name(type)
@@ -122,18 +149,6 @@ struct DataWriterDiscoveryItem : public DiscoveryItem
     {
     }
 
-    DataWriterDiscoveryItem(
-            GUID_t&& id,
-            std::string&& type,
-            std::string&& topic,
-            std::chrono::steady_clock::time_point&& discovered_timestamp)
-        : DiscoveryItem(id)
-        , type_name(std::move(type))
-        , topic_name(std::move(topic))
-        , discovered_timestamp_(std::move(discovered_timestamp))
-    {
-    }
-
     DataWriterDiscoveryItem() = delete;
     DataWriterDiscoveryItem(
             const DataWriterDiscoveryItem&) = default;
@@ -149,10 +164,10 @@ struct DataWriterDiscoveryItem : public DiscoveryItem
             const DataWriterDiscoveryItem&) const;
 
     //!Type name
-    std::string type_name;
+    InternedString type_name;
 
     //!Topic name
-    std::string topic_name;
+    InternedString topic_name;
 
     //!Discovered timestamp
     std::chrono::steady_clock::time_point discovered_timestamp_;
@@ -167,8 +182,8 @@ struct DataReaderDiscoveryItem : public DiscoveryItem
 {
     DataReaderDiscoveryItem(
             const GUID_t& id,
-            const std::string& type,
-            const std::string& topic,
+            const InternedString& type,
+            const InternedString& topic,
             const std::chrono::steady_clock::time_point& discovered_timestamp)
         : DiscoveryItem(id)
         , type_name(type)
@@ -177,18 +192,6 @@ struct DataReaderDiscoveryItem : public DiscoveryItem
     {
     }
 
-    DataReaderDiscoveryItem(
-            GUID_t&& id,
-            std::string&& type,
-            std::string&& topic,
-            std::chrono::steady_clock::time_point&& discovered_timestamp)
-        : DiscoveryItem(id)
-        , type_name(std::move(type))
-        , topic_name(std::move(topic))
-        , discovered_timestamp_(std::move(discovered_timestamp))
-    {
-    }
-
     DataReaderDiscoveryItem() = delete;
     DataReaderDiscoveryItem(
             const DataReaderDiscoveryItem&) = default;
@@ -200,10 +203,10 @@ struct DataReaderDiscoveryItem : public DiscoveryItem
             DataReaderDiscoveryItem&&) = default;
 
     //!Type name
-    std::string type_name;
+    InternedString type_name;
 
     //!Topic name
-    std::string topic_name;
+    InternedString topic_name;
 
     //!Discovered timestamp
     std::chrono::steady_clock::time_point discovered_timestamp_;
@@ -224,18 +227,26 @@ std::ostream& operator <<(
 //! participant discovery info
 struct ParticipantDiscoveryItem : public DiscoveryItem
 {
-    typedef std::set<DataWriterDiscoveryItem> publisher_set;
-    typedef std::set<DataReaderDiscoveryItem> subscriber_set;
+    // transparent comparators allow logarithmic lookups by GUID_t
+    typedef std::set<DataWriterDiscoveryItem, std::less<>, ArenaAllocator<DataWriterDiscoveryItem>> publisher_set;
+    typedef std::set<DataReaderDiscoveryItem, std::less<>, ArenaAllocator<DataReaderDiscoveryItem>> subscriber_set;
 
     // identity
     bool is_server; // false -> client
     bool is_alive; // false if death already reported but owned endpoints yet to be
     std::string participant_name;
     std::chrono::steady_clock::time_point discovered_timestamp_;
+    std::chrono::steady_clock::time_point zombie_since_; // death acknowledge time, only meaningful if not alive
+
+    // local user entities, shared among database copies till modified
+    struct Endpoints
+    {
+        publisher_set datawriters;
+        subscriber_set datareaders;
+    };
 
-    // local user entities
-    publisher_set datawriters;
-    subscriber_set datareaders;
+    std::shared_ptr<Endpoints> endpoints_; // null if there are no endpoints
+    uint64_t endpoints_owner_ = 0; // generation of the database allowed to modify endpoints_
 
     ParticipantDiscoveryItem(
             const GUID_t& id,
@@ -255,10 +266,10 @@ struct ParticipantDiscoveryItem : public DiscoveryItem
             std::string&& name = std::string(),
             bool server = false,
             const std::chrono::steady_clock::time_point& discovered_timestamp = std::chrono::steady_clock::now())
-        : DiscoveryItem(id)
+        : DiscoveryItem(std::move(id))
         , is_server(server)
         , is_alive(true)
-        , participant_name(name)
+        , participant_name(std::move(name))
         , discovered_timestamp_(discovered_timestamp)
     {
     }
@@ -295,24 +306,26 @@ struct ParticipantDiscoveryItem : public DiscoveryItem
     bool operator [](
             const DataReaderDiscoveryItem&) const;
 
-    //! modify death acknowledge state
+    //! modify death acknowledge state, a death acknowledge starts the zombie age
     void acknowledge(
             bool alive) const;
 
+    //! get datawriters
+    const publisher_set& getDataWriters() const;
+
+    //! get datareaders
+    const subscriber_set& getDataReaders() const;
+
     // the get methods allows us to workaround STL constrain on sets
     // that makes all its iterators constant
 
-    //! get datawriters
-    publisher_set& getDataWriters() const
-    {
-        return const_cast<publisher_set&>(datawriters);
-    }
+    //! get datawriters to modify, copied if shared with other database generations
+    publisher_set& getDataWriters(
+            uint64_t generation) const;
 
-    //! get datareaders
-    subscriber_set& getDataReaders() const
-    {
-        return const_cast<subscriber_set&>(datareaders);
-    }
+    //! get datareaders to modify, copied if shared with other database generations
+    subscriber_set& getDataReaders(
+            uint64_t generation) const;
 
     void setName(
             const std::string& name) const
@@ -320,6 +333,14 @@ struct ParticipantDiscoveryItem : public DiscoveryItem
         const_cast<std::string&>(participant_name) = name;
     }
 
+private:
+
+    //! endpoints owned by the given generation
+    Endpoints& ownEndpoints(
+            uint64_t generation) const;
+
+public:
+
     void setServer(
             bool& s) const
     {
@@ -344,10 +365,15 @@ std::ostream& operator <<(
         const ParticipantDiscoveryItem&);
 
 //! database, all discovery info associated with a participant
-struct ParticipantDiscoveryDatabase : public DiscoveryItem, public std::set<ParticipantDiscoveryItem>
+//! copies share the participants info till modified (copy on write) which keeps snapshots cheap
+//! and a modified copy still shares the nodes of the participants it did not modify
+struct ParticipantDiscoveryDatabase : public DiscoveryItem
 {
-    typedef std::set<ParticipantDiscoveryItem>::size_type size_type;
-    typedef ParticipantDiscoveryDatabase::iterator iterator;
+    typedef PersistentSet<ParticipantDiscoveryItem, std::less<>> participant_set;
+    typedef participant_set::size_type size_type;
+    typedef participant_set::value_type value_type;
+    typedef participant_set::const_iterator iterator;
+    typedef participant_set::const_iterator const_iterator;
 
     std::string participant_name_;
 
@@ -394,12 +420,14 @@ struct ParticipantDiscoveryDatabase : public DiscoveryItem, public std::set<Part
             const std::string& name = std::string())
         : DiscoveryItem(id)
         , participant_name_(name)
+        , body_(std::make_shared<Body>())
     {
     }
 
     ParticipantDiscoveryDatabase(
             GUID_t&& id)
         : DiscoveryItem(id)
+        , body_(std::make_shared<Body>())
     {
     }
 
@@ -413,14 +441,169 @@ struct ParticipantDiscoveryDatabase : public DiscoveryItem, public std::set<Part
     ParticipantDiscoveryDatabase& operator =(
             ParticipantDiscoveryDatabase&&) = default;
 
+    // read only access
+    const_iterator begin() const
+    {
+        return body_->participants.begin();
+    }
+
+    const_iterator end() const
+    {
+        return body_->participants.end();
+    }
+
+    const_iterator cbegin() const
+    {
+        return body_->participants.cbegin();
+    }
+
+    const_iterator cend() const
+    {
+        return body_->participants.cend();
+    }
+
+    size_type size() const
+    {
+        return body_->participants.size();
+    }
+
+    bool empty() const
+    {
+        return body_->participants.empty();
+    }
+
+    const_iterator find(
+            const GUID_t& id) const
+    {
+        return body_->participants.find(id);
+    }
+
+    const_iterator lower_bound(
+            const GUID_t& id) const
+    {
+        return body_->participants.lower_bound(id);
+    }
+
+    //! makes this copy the only owner of its participants info, required before any modification
+    //! only copies it while other copies reference it, once they are released it is modified in place
+    void detach();
+
+    //! running totals kept up to date by the modifiers
+    struct Counters
+    {
+        size_type alive = 0;
+        size_type zombies = 0;
+        size_type writers = 0;
+        size_type readers = 0;
+    };
+
+    const Counters& counters() const
+    {
+        return body_->counters;
+    }
+
+    //! identifies the participants info, only its generation can modify the items and their endpoints
+    uint64_t generation() const
+    {
+        return body_->generation;
+    }
+
+    // modifiers, the database must be detached first. Iterators are only valid while the generation is unchanged
+    // and only the one a modifier returns is valid after it
+    template<class ... Args>
+    iterator emplace_hint(
+            const_iterator,
+            Args&&... args)
+    {
+        assert(!shared());
+        std::pair<iterator, bool> res = body_->participants.emplace(generation(), std::forward<Args>(args)...);
+
+        if (res.second)
+        {
+            account(*res.first, true);
+        }
+
+        return res.first;
+    }
+
+    iterator erase(
+            const_iterator it)
+    {
+        assert(!shared());
+        account(*it, false);
+        return body_->participants.erase(generation(), it);
+    }
+
+    std::pair<iterator, bool> insert(
+            value_type&& item)
+    {
+        detach();
+        std::pair<iterator, bool> res = body_->participants.emplace(generation(), std::move(item));
+
+        if (res.second)
+        {
+            account(*res.first, true);
+        }
+
+        return res;
+    }
+
+    //! item to modify, copied with its path if shared with other generations. Keep the returned iterator
+    iterator own(
+            const_iterator it)
+    {
+        assert(!shared());
+        return body_->participants.own(generation(), it);
+    }
+
+    //! modifies an item, liveliness and endpoints must only be changed this way to keep the counters
+    //! it is moved to the owned item
+    template<class F>
+    void modify(
+            const_iterator& it,
+            F f)
+    {
+        it = own(it);
+        account(*it, false);
+        f(*it);
+        account(*it, true);
+    }
+
     smart_iterator sbegin() const;
     smart_iterator send() const;
     size_type real_size() const;
 
     size_type CountParticipants() const;
+    size_type CountZombies() const;
     size_type CountDataReaders() const;
     size_type CountDataWriters() const;
 
+private:
+
+    //! other copies reference body_, stale at most towards false once they are released
+    bool shared() const
+    {
+        return body_.use_count() > 1;
+    }
+
+    //! adds or removes an item contribution to the counters
+    void account(
+            const ParticipantDiscoveryItem& item,
+            bool add);
+
+    //! participants info shared among copies
+    struct Body
+    {
+        participant_set participants;
+        Counters counters;
+        uint64_t generation;
+
+        Body();
+        Body(
+                const Body&);
+    };
+
+    std::shared_ptr<Body> body_;
 };
 
 bool operator ==(
@@ -431,7 +614,7 @@ std::ostream& operator <<(
         const ParticipantDiscoveryDatabase&);
 
 //! Snapshot, discovery info associated with all participants
-struct Snapshot : public std::set<ParticipantDiscoveryDatabase>
+struct Snapshot : public std::set<ParticipantDiscoveryDatabase, std::less<>, ArenaAllocator<ParticipantDiscoveryDatabase>>
 {
     // process time
     std::chrono::steady_clock::time_point process_startup_;
@@ -518,65 +701,385 @@ struct Snapshot : public std::set<ParticipantDiscoveryDatabase>
 
     void from_xml(
             tinyxml2::XMLElement* pRoot);
+
+    //! recreates the time points from the ms values kept in the snapshot files
+    void restore_times(
+            std::chrono::milliseconds timestamp,
+            std::chrono::milliseconds process_time,
+            std::chrono::milliseconds last_pdp_callback,
+            std::chrono::milliseconds last_edp_callback);
 };
 
 std::ostream& operator <<(
         std::ostream&,
         const Snapshot&);
 
+//! endpoint reported on a topic and the spokesmen that know about it
+struct TopicEndpoint
+{
+    GUID_t endpoint;
+    InternedString type_name;
+    std::vector<GUID_t> spokesmen;
+};
+
+//! endpoints on a topic, matched if there is a counterpart endpoint with the same type (QoS is not considered)
+struct TopicMatches
+{
+    std::vector<TopicEndpoint> matched_writers;
+    std::vector<TopicEndpoint> matched_readers;
+    std::vector<TopicEndpoint> unmatched_writers;
+    std::vector<TopicEndpoint> unmatched_readers;
+};
+
+//! zombie participants over all spokesmen
+struct ZombieStatistics
+{
+    //! ages are bucketed by powers of ten seconds: under 1s, 10s, 100s, 1000s, 10000s and older
+    static const std::size_t age_buckets = 6;
+
+    std::size_t zombies = 0; // participants whose death was reported but own endpoints
+    std::size_t reaped = 0;  // zombies removed by the reaper so far
+    std::array<std::size_t, age_buckets> ages{};
+};
+
+std::ostream& operator <<(
+        std::ostream&,
+        const ZombieStatistics&);
+
+//! cross spokesman index of the reported endpoints by topic and type
+class TopicIndex
+{
+public:
+
+    //! topic and type names
+    typedef std::pair<InternedString, InternedString> topic_key;
+
+private:
+
+    typedef std::set<GUID_t, std::less<GUID_t>, ArenaAllocator<GUID_t>> spokesmen_set;
+
+    //! endpoint to the spokesmen that reported it
+    typedef std::map<GUID_t, spokesmen_set, std::less<GUID_t>,
+                    ArenaAllocator<std::pair<const GUID_t, spokesmen_set>>> endpoint_map;
+
+    struct Entry
+    {
+        endpoint_map writers;
+        endpoint_map readers;
+    };
+
+    typedef std::map<topic_key, Entry, std::less<topic_key>, ArenaAllocator<std::pair<const topic_key, Entry>>> topic_map;
+
+    //! all the keys of a topic name live on the same stripe, so queries lock a single one
+    struct Stripe
+    {
+        std::shared_ptr<DiscoveryArena> arena; // stripe nodes, must be in scope on insertions
+        topic_map topics;
+        std::set<topic_key, std::less<topic_key>, ArenaAllocator<topic_key>> unmatched; // only writers or readers
+        mutable std::mutex mutex;
+
+        Stripe();
+    };
+
+    static const std::size_t stripe_count = 16;
+    std::array<Stripe, stripe_count> stripes_;
+
+    Stripe& stripe(
+            const InternedString& topic);
+
+    const Stripe& stripe(
+            const InternedString& topic) const;
+
+    void Add(
+            endpoint_map Entry::* side,
+            const topic_key& key,
+            const GUID_t& spokesman,
+            const GUID_t& endpoint);
+
+    void Remove(
+            endpoint_map Entry::* side,
+            const topic_key& key,
+            const GUID_t& spokesman,
+            const GUID_t& endpoint);
+
+    //! refreshes the unmatched keys and drops the entry if empty, the stripe must be locked
+    static void Update(
+            Stripe& stripe,
+            topic_map::iterator it);
+
+    static void Report(
+            const endpoint_map& endpoints,
+            const InternedString& type_name,
+            std::vector<TopicEndpoint>& result);
+
+public:
+
+    void Add(
+            const GUID_t& spokesman,
+            const DataWriterDiscoveryItem& writer);
+
+    void Add(
+            const GUID_t& spokesman,
+            const DataReaderDiscoveryItem& reader);
+
+    void Remove(
+            const GUID_t& spokesman,
+            const DataWriterDiscoveryItem& writer);
+
+    void Remove(
+            const GUID_t& spokesman,
+            const DataReaderDiscoveryItem& reader);
+
+    //! removes all the endpoints reported by a spokesman
+    void Remove(
+            const ParticipantDiscoveryDatabase& database);
+
+    //! endpoints on a topic, cost proportional to the result size
+    TopicMatches Query(
+            const InternedString& topic) const;
+
+    //! topic and type pairs that only have writers or only readers, in key order
+    std::vector<topic_key> Unmatched() const;
+};
+
+//! reverse index from each reported participant to the spokesmen that know it
+class ParticipantIndex
+{
+    typedef std::set<GUID_t, std::less<GUID_t>, ArenaAllocator<GUID_t>> spokesmen_set;
+    typedef std::unordered_map<GUID_t, spokesmen_set, GUIDHash, std::equal_to<GUID_t>,
+                    ArenaAllocator<std::pair<const GUID_t, spokesmen_set>>> spokesmen_map;
+
+    //! participants are spread over the stripes by GUID hash
+    struct Stripe
+    {
+        std::shared_ptr<DiscoveryArena> arena; // stripe nodes, must be in scope on insertions
+        spokesmen_map participants;
+        mutable std::mutex mutex;
+
+        Stripe();
+    };
+
+    static const std::size_t stripe_count = 16;
+    std::array<Stripe, stripe_count> stripes_;
+
+    Stripe& stripe(
+            const GUID_t& ptid);
+
+    const Stripe& stripe(
+            const GUID_t& ptid) const;
+
+public:
+
+    void Add(
+            const GUID_t& spokesman,
+            const GUID_t& ptid);
+
+    void Remove(
+            const GUID_t& spokesman,
+            const GUID_t& ptid);
+
+    //! removes all the participants reported by a spokesman
+    void Remove(
+            const ParticipantDiscoveryDatabase& database);
+
+    //! spokesmen that know the participant
+    std::vector<GUID_t> Find(
+            const GUID_t& ptid) const;
+
+    //! number of spokesmen that know the participant
+    std::size_t Count(
+            const GUID_t& ptid) const;
+};
+
 //! DiscoveryItemDatabase, auxiliary class to populate and manage Snapshots
 class DiscoveryItemDatabase
 {
     typedef ParticipantDiscoveryDatabase::size_type size_type;
 
+    //! endpoint location on a shard database, only valid while the database generation is unchanged
+    template<class T>
+    struct EndpointHandle
+    {
+        ParticipantDiscoveryDatabase::iterator participant;
+        typename T::iterator endpoint;
+        uint64_t generation;
+    };
+
+    //! endpoint GUID to handle, endpoint GUIDs are unique on a spokesman
+    template<class T>
+    using handle_map = std::unordered_map<GUID_t, EndpointHandle<T>, GUIDHash, std::equal_to<GUID_t>,
+                    ArenaAllocator<std::pair<const GUID_t, EndpointHandle<T>>>>;
+
+    //! each spokesman discovery info is kept on its own shard to avoid callback contention
+    struct Shard
+    {
+        std::mutex shard_mutex; // atomic shard operation
+        std::shared_ptr<DiscoveryArena> arena; // nodes of all the shard versions, must be in scope on modifications
+        ParticipantDiscoveryDatabase database;
+
+        // handles of all the reported endpoints, refreshed lazily once the database is detached
+        handle_map<ParticipantDiscoveryItem::publisher_set> writers;
+        handle_map<ParticipantDiscoveryItem::subscriber_set> readers;
+
+        //! the arena must be in scope
+        Shard(
+                const GUID_t& spokesman,
+                const std::string& name,
+                std::shared_ptr<DiscoveryArena> shard_arena)
+            : arena(std::move(shard_arena))
+            , database(spokesman, name)
+        {
+        }
+
+        //! current version, shares the info with the shard which will copy it before any modification
+        ParticipantDiscoveryDatabase publish() const
+        {
+            return database;
+        }
+
+        //! database to modify, copied if the current version was published
+        ParticipantDiscoveryDatabase& writable()
+        {
+            database.detach();
+            return database;
+        }
+
+    };
+
+    typedef std::map<GUID_t, std::unique_ptr<Shard>> shard_map;
+
+    //! exclusive access to a single shard, the shard map cannot change meanwhile
+    struct ShardAccess
+    {
+        std::shared_lock<std::shared_timed_mutex> map_lock;
+        std::unique_lock<std::mutex> shard_lock;
+        Shard* shard = nullptr;
+    };
+
     // reported discovery info
-    Snapshot image; // each participant database info
-    mutable std::mutex database_mutex; // atomic database operation
+    shard_map shards; // each participant database info
+    mutable std::shared_timed_mutex shards_mutex; // exclusive only for shard creation and removal
+    TopicIndex topics; // endpoints by topic, locked after the shards
+    ParticipantIndex participants; // spokesmen by participant, locked after the shards
+    DiscoveryJournal journal; // mutations, recorded with the shard locked, lock free but for the slot written
+    DiscoveryNotifier notifier{journal}; // journal observers
+
+    // totals over all spokesmen
+    std::atomic<size_type> total_alive_{0};
+    std::atomic<size_type> total_zombies_{0};
+    std::atomic<size_type> total_writers_{0};
+    std::atomic<size_type> total_readers_{0};
+    std::atomic<size_type> total_reaped_{0};
+
+    //! updates the totals with the changes on a shard counters when leaving the scope, shard must be locked
+    class Accounting
+    {
+        DiscoveryItemDatabase& owner_;
+        const ParticipantDiscoveryDatabase& database_;
+        ParticipantDiscoveryDatabase::Counters before_;
+
+    public:
+
+        Accounting(
+                DiscoveryItemDatabase& owner,
+                const ParticipantDiscoveryDatabase& database)
+            : owner_(owner)
+            , database_(database)
+            , before_(database.counters())
+        {
+        }
+
+        ~Accounting();
+    };
+    std::chrono::steady_clock::time_point creation_time_;
+
+    //! locks the spokesman shard, shard is null if not there
+    ShardAccess LockShard(
+            const GUID_t& spokesman) const;
+
+    //! locks the spokesman shard, creating it if not there
+    ShardAccess AccessShard(
+            const GUID_t& spokesman,
+            const std::string& name);
+
+    //! locks all shards in order for a consistent view, shards_mutex must be locked
+    std::vector<std::unique_lock<std::mutex>> LockAllShards() const;
+
+    //! consistent set of immutable versions of all spokesmen databases, optionally with the last change they reflect
+    std::vector<ParticipantDiscoveryDatabase> GetVersions(
+            uint64_t* sequence = nullptr) const;
+
+    //! records a mutation, the modified shard must be locked
+    void Journal(
+            JournalEntry::Kind kind,
+            const GUID_t& spokesman,
+            const GUID_t& ptid,
+            const GUID_t& endpoint = GUID_t::unknown(),
+            const InternedString& type_name = InternedString(),
+            const InternedString& topic_name = InternedString());
 
     // AddDataReader and AddDataWriter common implementation
 
     template<
         class T>
-    bool AddEndPoint(T & (ParticipantDiscoveryItem::* m)() const,
+    bool AddEndPoint(T & (ParticipantDiscoveryItem::* m)(uint64_t) const,
+            handle_map<T> Shard::* h,
             const GUID_t& spokesman,
             const std::string& srcName,
             const GUID_t& ptid,
             const GUID_t& sid,
-            const std::string& _typename,
-            const std::string& topicname,
+            const InternedString& _typename,
+            const InternedString& topicname,
             const std::chrono::steady_clock::time_point& discovered_timestamp);
 
     template<
         class T>
-    bool RemoveEndPoint(T & (ParticipantDiscoveryItem::* m)() const,
+    bool RemoveEndPoint(T & (ParticipantDiscoveryItem::* m)(uint64_t) const,
+            handle_map<T> Shard::* h,
             const GUID_t& spokesman,
             const GUID_t& ptid,
             const GUID_t& sid);
 
+    //! valid handle of a participant endpoint or handles.end() if not there, database must be detached
+    template<
+        class T>
+    typename handle_map<T>::iterator ResolveEndPoint(T & (ParticipantDiscoveryItem::* m)(uint64_t) const,
+            handle_map<T>& handles,
+            ParticipantDiscoveryDatabase& database,
+            const GUID_t& ptid,
+            const GUID_t& sid);
+
 public:
 
     DiscoveryItemDatabase()
-        : image(std::chrono::steady_clock::now()
-                , std::chrono::steady_clock::now())
+        : creation_time_(std::chrono::steady_clock::now())
     {
     }
 
     //! Get Snapshot time
     std::chrono::steady_clock::time_point getTime() const
     {
-        return image._time;
+        return creation_time_;
     }
 
     //! Returns a pointer to the ParticipantDiscoveryItem or null if not found
     std::vector<const ParticipantDiscoveryItem*> FindParticipant(
             const GUID_t& ptid) const;
 
-    //! Adds a new participant, returns false if allocation fails
+    //! spokesmen that know the participant
+    std::vector<GUID_t> FindSpokesmen(
+            const GUID_t& ptid) const;
+
+    //! number of spokesmen the participant has propagated to
+    std::size_t CountSpokesmen(
+            const GUID_t& ptid) const;
+
+    //! Adds a new participant, returns false if allocation fails. The name is moved into the new item
     bool AddParticipant(
             const GUID_t& spokesman,
             const std::string& srcName,
             const GUID_t& ptid,
-            const std::string& name = std::string(),
+            std::string name = std::string(),
             const std::chrono::steady_clock::time_point& discovered_timestamp = std::chrono::steady_clock::now(),
             bool server = false);
 
@@ -595,8 +1098,8 @@ public:
             const std::string& srcName,
             const GUID_t& ptid,
             const GUID_t& sid,
-            const std::string& _typename,
-            const std::string& topicname,
+            const InternedString& _typename,
+            const InternedString& topicname,
             const std::chrono::steady_clock::time_point& discovered_timestamp);
 
     bool RemoveDataReader(
@@ -610,8 +1113,8 @@ public:
             const std::string& srcName,
             const GUID_t& ptid,
             const GUID_t& pid,
-            const std::string& _typename,
-            const std::string& topicname,
+            const InternedString& _typename,
+            const InternedString& topicname,
             const std::chrono::steady_clock::time_point& discovered_timestamp);
 
     bool RemoveDataWriter(
@@ -624,8 +1127,16 @@ public:
             int32_t alive_count,
             int32_t not_alive_count);
 
+    //! totals over all spokesmen, a participant known by several spokesmen is counted by each of them
+    size_type CountParticipants() const;
+    size_type CountZombies() const;
+    size_type CountDataReaders() const;
+    size_type CountDataWriters() const;
+
     size_type CountParticipants(
             const GUID_t& spokesman ) const;
+    size_type CountZombies(
+            const GUID_t& spokesman ) const;
     size_type CountDataReaders(
             const GUID_t& spokesman ) const;
     size_type CountDataWriters(
@@ -637,12 +1148,49 @@ public:
             const GUID_t& spokesman,
             const GUID_t& ptid) const;
 
-    // Get a copy the current SnapShot
-    Snapshot GetState() const
-    {
-        std::lock_guard<std::mutex> lock(database_mutex);
-        return image;
-    }
+    //! writers and readers on a topic, reported by any spokesman
+    TopicMatches QueryTopic(
+            const std::string& topic) const;
+
+    //! topic and type pairs without a counterpart endpoint
+    std::vector<TopicIndex::topic_key> UnmatchedTopics() const;
+
+    //! removes the zombies whose death was acknowledged longer than grace ago, together with their endpoints
+    size_type ReapZombies(
+            const std::chrono::steady_clock::duration& grace,
+            const std::chrono::steady_clock::time_point& now = std::chrono::steady_clock::now());
+
+    //! zombie count and age histogram, each shard is visited under its lock without publishing it
+    ZombieStatistics GetZombieStatistics(
+            const std::chrono::steady_clock::time_point& now = std::chrono::steady_clock::now()) const;
+
+    // Get a copy the current SnapShot, writers are not blocked during the copy
+    Snapshot GetState() const;
+
+    //! copy of the current Snapshot and the sequence of the last change it reflects
+    Snapshot GetState(
+            uint64_t& sequence) const;
+
+    //! appends the changes after the since sequence, false if the journal already discarded some of them
+    bool ChangesSince(
+            uint64_t since,
+            std::vector<JournalEntry>& changes) const;
+
+    //! sequence of the last change
+    uint64_t LastSequence() const;
+
+    //! observers get the changes matching their filter in batches, on their executor or the notifier thread
+    ObserverId Subscribe(
+            ObserverFilter filter,
+            ObserverCallback callback,
+            ObserverExecutor executor = nullptr,
+            uint64_t since = std::numeric_limits<uint64_t>::max());
+
+    void Unsubscribe(
+            ObserverId id);
+
+    //! hands the pending changes to the observers now instead of on the next notifier period
+    void DispatchChanges();
 
 };
 
@@ -0,0 +1,141 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _DISCOVERY_JOURNAL_H_
+#define _DISCOVERY_JOURNAL_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include <fastdds/rtps/common/Guid.hpp>
+
+#include "InternedString.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+//! a single DiscoveryItemDatabase mutation
+struct JournalEntry
+{
+    enum class Kind : uint8_t
+    {
+        ADD_PARTICIPANT,    // participant reported alive, either new or a revived zombie
+        ZOMBIE_PARTICIPANT, // participant reported dead or unknown but owning endpoints
+        REMOVE_PARTICIPANT, // participant and all its endpoints are gone
+        ADD_DATAREADER,
+        REMOVE_DATAREADER,
+        ADD_DATAWRITER,
+        REMOVE_DATAWRITER,
+        UPDATE_LIVELINESS,
+        REMOVE_SPOKESMAN    // all the info reported by the spokesman is gone
+    };
+
+    uint64_t sequence = 0; // assigned on record, consecutive
+    Kind kind = Kind::ADD_PARTICIPANT;
+    fastdds::rtps::GUID_t spokesman;
+    fastdds::rtps::GUID_t participant;
+    fastdds::rtps::GUID_t endpoint;  // unknown for participant changes
+    InternedString type_name;        // endpoint changes only
+    InternedString topic_name;       // endpoint changes only
+    int32_t alive_count = 0;         // liveliness updates only
+    int32_t not_alive_count = 0;     // liveliness updates only
+    std::chrono::steady_clock::time_point timestamp; // record time
+};
+
+std::ostream& operator <<(
+        std::ostream&,
+        JournalEntry::Kind);
+std::ostream& operator <<(
+        std::ostream&,
+        const JournalEntry&);
+
+/**
+ * Bounded in-memory journal of database mutations. Each entry gets a sequence number one above the
+ * previous one, so consumers can fetch the changes since the last sequence they processed instead
+ * of comparing whole snapshots. The oldest entries are discarded once the capacity is reached.
+ * Writers claim their sequence with an atomic increment and only lock the ring slot they fill, so
+ * concurrent records from different shards do not serialize.
+ **/
+class DiscoveryJournal
+{
+public:
+
+    explicit DiscoveryJournal(
+            std::size_t capacity = 65536);
+
+    ~DiscoveryJournal();
+
+    DiscoveryJournal(
+            const DiscoveryJournal&) = delete;
+    DiscoveryJournal& operator =(
+            const DiscoveryJournal&) = delete;
+
+    //! thread safe, returns the sequence assigned to the entry
+    uint64_t Record(
+            JournalEntry&& entry);
+
+    /**
+     * appends the entries with sequence above since to changes. Returns false if some of them were
+     * already discarded, then the consumer must start over from a snapshot and LastSequence().
+     * Stops before the first entry claimed but not yet filled, the rest is returned on later calls
+     **/
+    bool Since(
+            uint64_t since,
+            std::vector<JournalEntry>& changes) const;
+
+    //! sequence of the last claimed entry, 0 if none. Filled too if the writers were kept out meanwhile
+    uint64_t LastSequence() const;
+
+    //! sequence of the oldest entry kept, LastSequence() + 1 if empty
+    uint64_t FirstSequence() const;
+
+private:
+
+    //! sequence 0 in the entry marks the slot as never filled
+    struct Slot
+    {
+        mutable std::mutex mutex;
+        JournalEntry entry;
+    };
+
+    //! slots are allocated in chunks on first use and never move
+    static const std::size_t chunk_bits = 10;
+    static const std::size_t chunk_size = std::size_t(1) << chunk_bits;
+
+    struct Chunk
+    {
+        std::array<Slot, chunk_size> slots;
+    };
+
+    //! slot of the sequence, null if its chunk was never allocated and create is false
+    Slot* slot(
+            uint64_t sequence,
+            bool create) const;
+
+    const std::size_t capacity_;
+    std::unique_ptr<std::atomic<Chunk*>[]> chunks_; // entry with sequence s is at (s - 1) % capacity_
+    std::atomic<uint64_t> last_sequence_{0}; // last sequence claimed
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _DISCOVERY_JOURNAL_H_
@@ -0,0 +1,128 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _DISCOVERY_NOTIFIER_H_
+#define _DISCOVERY_NOTIFIER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "DiscoveryJournal.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+//! changes selected by an observer, empty criteria select everything
+struct ObserverFilter
+{
+    std::vector<fastdds::rtps::GUID_t> spokesmen;
+    std::vector<fastdds::rtps::GUID_t> participants;
+    std::vector<InternedString> topics;
+
+    //! a spokesman removal matches any participant or topic criteria of its spokesman
+    bool matches(
+            const JournalEntry& entry) const;
+};
+
+//! batch of changes delivered to an observer
+struct DiscoveryChanges
+{
+    std::vector<JournalEntry> entries; // in sequence order
+    bool lost = false; // the journal discarded changes before delivery, resync from a snapshot
+};
+
+typedef uint64_t ObserverId;
+typedef std::function<void(const DiscoveryChanges&)> ObserverCallback;
+//! runs a notification task, a null executor runs it on the notifier thread
+typedef std::function<void(std::function<void()>)> ObserverExecutor;
+
+/**
+ * Delivers the journal changes to the registered observers. A dedicated thread, started on the first
+ * subscription, polls the journal and hands each observer its filtered batch through the observer
+ * executor. Observers are never called from the threads that modify the database.
+ **/
+class DiscoveryNotifier
+{
+public:
+
+    //! changes are gathered for period before being delivered
+    explicit DiscoveryNotifier(
+            const DiscoveryJournal& journal,
+            std::chrono::milliseconds period = std::chrono::milliseconds(50));
+
+    //! stops the notifier thread, pending changes are not delivered
+    ~DiscoveryNotifier();
+
+    DiscoveryNotifier(
+            const DiscoveryNotifier&) = delete;
+    DiscoveryNotifier& operator =(
+            const DiscoveryNotifier&) = delete;
+
+    //! only changes after since are delivered, by default the ones after the subscription
+    ObserverId Subscribe(
+            ObserverFilter filter,
+            ObserverCallback callback,
+            ObserverExecutor executor = nullptr,
+            uint64_t since = std::numeric_limits<uint64_t>::max());
+
+    //! no batch is handed to the observer executor after returning, unless called from a callback
+    void Unsubscribe(
+            ObserverId id);
+
+    //! hands the pending changes over now, from the calling thread, without waiting for the period
+    void Dispatch();
+
+private:
+
+    struct Observer
+    {
+        ObserverId id;
+        ObserverFilter filter;
+        std::shared_ptr<ObserverCallback> callback; // kept alive by the executor tasks
+        ObserverExecutor executor;
+        uint64_t delivered; // last sequence handed to the observer
+    };
+
+    void run();
+
+    //! delivers the new changes to each observer, dispatch_mutex_ must be locked
+    void dispatch();
+
+    const DiscoveryJournal& journal_;
+    const std::chrono::milliseconds period_;
+
+    std::mutex mutex_; // observers and thread state
+    std::condition_variable wakeup_;
+    std::vector<Observer> observers_;
+    ObserverId next_id_ = 0;
+    bool stop_ = false;
+    std::thread notifier_;
+
+    std::mutex dispatch_mutex_; // held while batches are handed over
+    std::atomic<std::thread::id> dispatcher_; // thread holding dispatch_mutex_
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _DISCOVERY_NOTIFIER_H_
@@ -16,10 +16,17 @@
 #ifndef _DSMANAGER_H_
 #define _DSMANAGER_H_
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <regex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include <fastdds/dds/domain/DomainParticipant.hpp>
@@ -30,7 +37,11 @@
 #include <fastdds/dds/publisher/Publisher.hpp>
 
 
+#include "DiscoveryEventQueue.h"
 #include "DiscoveryItem.h"
+#include "DiscoveryStagingBuffers.h"
+#include "InternedString.h"
+#include "SnapshotXmlReader.h"
 
 using namespace eprosima::fastdds;
 using namespace eprosima::fastdds::rtps;
@@ -54,13 +65,13 @@ namespace discovery_server {
 
 struct ParticipantCreatedEntityInfo
 {
-    DomainParticipant* participant;
-    fastdds::dds::Publisher* publisher;
-    fastdds::dds::Topic* publisherTopic;
-    fastdds::dds::TopicDataType* publisherType;
-    fastdds::dds::Subscriber* subscriber;
-    fastdds::dds::Topic* subscriberTopic;
-    fastdds::dds::TopicDataType* subscriberType;
+    DomainParticipant* participant = nullptr;
+    fastdds::dds::Publisher* publisher = nullptr;
+    fastdds::dds::Topic* publisherTopic = nullptr;
+    fastdds::dds::TopicDataType* publisherType = nullptr;
+    fastdds::dds::Subscriber* subscriber = nullptr;
+    fastdds::dds::Topic* subscriberTopic = nullptr;
+    fastdds::dds::TopicDataType* subscriberType = nullptr;
     std::map<std::string, fastdds::dds::Topic*> registeredTopics;
 
     ParticipantCreatedEntityInfo() = default;
@@ -80,6 +91,53 @@ struct ParticipantCreatedEntityInfo
 
 };
 
+//! kind of participant created by the DiscoveryServerManager
+enum class ParticipantRole
+{
+    SERVER,
+    CLIENT,
+    SIMPLE
+};
+
+//! how the discovery callbacks hand their changes to the database, overrides the config file attributes
+enum class IngestionMode
+{
+    CONFIG,
+    INGESTION_QUEUE,
+    STAGING_BUFFERS
+};
+
+//! local participant info, metadata is cached on registration to avoid qos copies on callbacks
+struct ParticipantRegistryEntry
+{
+    ParticipantRole role;
+    GUID_t guid;
+    std::string name;
+    InternedString symbol; // name as reported by the discovery callbacks, avoids copies
+    ParticipantCreatedEntityInfo info;
+
+    ParticipantRegistryEntry(
+            ParticipantRole r,
+            DomainParticipant* p)
+        : ParticipantRegistryEntry(r, p->guid(), p->get_qos().name().to_string())
+    {
+        info.participant = p;
+    }
+
+    //! metadata only, no participant attached
+    ParticipantRegistryEntry(
+            ParticipantRole r,
+            const GUID_t& id,
+            const std::string& n)
+        : role(r)
+        , guid(id)
+        , name(n)
+        , symbol(name)
+    {
+    }
+
+};
+
 class LateJoinerData;
 class DelayedParticipantCreation;
 class DelayedParticipantDestruction;
@@ -89,26 +147,20 @@ class DiscoveryServerManager
                                                                // subscriber lifeliness information
 
 {
-    typedef std::map<GUID_t, DomainParticipant*> participant_map;
+    typedef std::unordered_map<GUID_t, ParticipantRegistryEntry, GUIDHash> participant_registry;
+    // ordered by prefix first, a participant endpoints are a contiguous range
     typedef std::map<GUID_t, DataReader*> data_reader_map;
     typedef std::map<GUID_t, DataWriter*> data_writer_map;
     typedef std::map<GUID_t, std::pair<LocatorList_t, LocatorList_t>> serverLocator_map;  // multi, unicast locator list
     typedef std::vector<LateJoinerData*> event_list;
     typedef std::vector<Snapshot> snapshots_list;
 
-    typedef std::map<GUID_t, ParticipantCreatedEntityInfo> created_entity_map;
-
-    // synch protection
-    std::recursive_mutex management_mutex;
+    // synch protection: shared by callbacks and lookups, exclusive to modify the registries
+    mutable std::shared_timed_mutex management_mutex;
 
-    // Participant maps
-    participant_map servers;
-    participant_map clients;
-    participant_map simples;
-
-    // Map to hold the information regarding Participants and their associated Publishers, Subscribers and Topics
+    // Participants created by this process with their associated Publishers, Subscribers and Topics
     // Indexed by GUID
-    created_entity_map entity_map;
+    participant_registry participants;
 
     // endpoints maps
     data_reader_map data_readers;
@@ -121,6 +173,24 @@ class DiscoveryServerManager
     DiscoveryItemDatabase state;
     std::chrono::steady_clock::time_point getTime() const;
 
+    // callbacks events applier, null if callbacks modify the state synchronously
+    std::unique_ptr<DiscoveryIngestion> ingestion_;
+
+    // forwards the event to the ingestion queue or applies it
+    void ingest(
+            DiscoveryEvent&& event);
+    // waits till the state reflects all callbacks received
+    void syncState() const;
+
+    // zombie reaper, removes zombie participants from the state once the grace period expires
+    std::thread reaper_;
+    std::mutex reaper_mutex_;
+    std::condition_variable reaper_cv_;
+    bool reaper_stop_ = false;
+    void runReaper(
+            std::chrono::seconds grace);
+    void stopReaper();
+
     // Event list for late joiner creation, destruction and take snapshots
     // only modified from the main thread (no synchronization required)
     event_list events;
@@ -136,6 +206,17 @@ class DiscoveryServerManager
     bool enable_prefix_validation; // allow multiple servers share the same prefix? (only for testing purposes)
     bool correctly_created_;     // store false if the DiscoveryServerManager has not been successfully created
 
+    // participant registry ancillary
+    void addParticipant(
+            DomainParticipant* p,
+            ParticipantRole role);
+    // returns nullptr if not there, management_mutex must be locked
+    ParticipantRegistryEntry* findParticipant(
+            const GUID_t& id);
+    // participant name for logging or its prefix if unknown, management_mutex must be locked
+    std::string participantLabel(
+            const GUID_t& id);
+
     void loadProfiles(
             tinyxml2::XMLElement* profiles);
     void loadServer(
@@ -171,11 +252,17 @@ class DiscoveryServerManager
 
     // File where to save snapshots
     std::string snapshots_output_file;
+    // save snapshots in the binary format whatever the file extension
+    bool binary_snapshots_{false};
+    // save XML snapshots in the normalized encoding
+    bool normalized_snapshots_{false};
+    // snapshots to load from snapshot files
+    SnapshotFilter snapshot_filter_;
     // validation required
     bool validate_{false};
-    // last callback recorded time
-    std::chrono::steady_clock::time_point last_PDP_callback_;
-    std::chrono::steady_clock::time_point last_EDP_callback_;
+    // last callback recorded time, updated by callbacks holding the shared lock
+    std::atomic<std::chrono::steady_clock::time_point> last_PDP_callback_;
+    std::atomic<std::chrono::steady_clock::time_point> last_EDP_callback_;
     // last snapshot delay, needed for sync purposes
     static const std::chrono::seconds last_snapshot_delay_;
 
@@ -183,9 +270,12 @@ class DiscoveryServerManager
 
 public:
 
+    // a snapshot file only loads the snapshots selected by the filter
     DiscoveryServerManager(
             const std::string& xml_file_path,
-            const bool shared_memory_off);
+            const bool shared_memory_off,
+            SnapshotFilter snapshot_filter = nullptr,
+            IngestionMode ingestion_mode = IngestionMode::CONFIG);
 
     ~DiscoveryServerManager();
 
@@ -343,8 +433,29 @@ public:
         snapshots_output_file = file_path;
     }
 
+    // snapshots are saved in the binary format, otherwise only if the output file has the .dssnap extension
+    void binary_snapshots(
+            bool binary)
+    {
+        binary_snapshots_ = binary;
+    }
+
+    // XML snapshots list each participant and endpoint once, the databases reference them
+    void normalized_snapshots(
+            bool normalized)
+    {
+        normalized_snapshots_ = normalized;
+    }
+
+    // zombies are reaped once dead for longer than grace, zero disables the reaper
+    void zombie_grace_period(
+            std::chrono::seconds grace);
+
 };
 
+std::ostream& operator <<(
+        std::ostream&,
+        ParticipantRole);
 std::ostream& operator <<(
         std::ostream&,
         ParticipantDiscoveryStatus);
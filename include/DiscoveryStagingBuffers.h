@@ -0,0 +1,113 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _DISCOVERY_STAGING_BUFFERS_H_
+#define _DISCOVERY_STAGING_BUFFERS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#include "DiscoveryEventQueue.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+/**
+ * Each pushing thread appends its discovery events to a buffer of its own. The buffers are merged
+ * into the DiscoveryItemDatabase, in push time order, only when a consistent view is required.
+ * A buffer lock is only contended by merges, pushing threads never share locks.
+ **/
+class DiscoveryStagingBuffers : public DiscoveryIngestion
+{
+public:
+
+    struct Statistics
+    {
+        uint64_t staged;          // events pushed
+        uint64_t merged;          // events replayed on the database
+        uint64_t merges;          // merges with pending events
+        uint64_t overflow_merges; // merges triggered by a full buffer
+        uint64_t max_merge;       // largest number of events replayed by a merge
+        uint64_t buffers;         // threads that ever pushed
+    };
+
+    //! a buffer holding max_pending events is merged by its own thread
+    DiscoveryStagingBuffers(
+            DiscoveryItemDatabase& database,
+            std::size_t max_pending = 65536);
+
+    //! merges all pending events before returning
+    ~DiscoveryStagingBuffers() override;
+
+    DiscoveryStagingBuffers(
+            const DiscoveryStagingBuffers&) = delete;
+    DiscoveryStagingBuffers& operator =(
+            const DiscoveryStagingBuffers&) = delete;
+
+    //! thread safe, only takes the calling thread buffer lock
+    void push(
+            DiscoveryEvent&& event) override;
+
+    //! merges into the database all the events staged before the call, successive merges keep the push order
+    void flush() override;
+
+    void report(
+            std::ostream& os) const override;
+
+    Statistics statistics() const;
+
+private:
+
+    struct Staged
+    {
+        std::chrono::steady_clock::time_point staged_at;
+        DiscoveryEvent event;
+    };
+
+    struct Buffer
+    {
+        std::mutex mutex; // owner thread against merges
+        std::vector<Staged> events;
+        uint64_t staged = 0;
+    };
+
+    //! calling thread buffer, registered on first use
+    Buffer& local();
+
+    DiscoveryItemDatabase& database_;
+    const uint64_t id_; // identifies this instance on the thread local caches
+    const std::size_t max_pending_;
+
+    mutable std::mutex buffers_mutex_;
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+
+    std::mutex merge_mutex_; // merges must not interleave
+
+    // statistics
+    std::atomic<uint64_t> merged_{0};
+    std::atomic<uint64_t> merges_{0};
+    std::atomic<uint64_t> overflow_merges_{0};
+    std::atomic<uint64_t> max_merge_{0};
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _DISCOVERY_STAGING_BUFFERS_H_
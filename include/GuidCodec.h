@@ -0,0 +1,64 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _GUID_CODEC_H_
+#define _GUID_CODEC_H_
+
+#include <cstddef>
+
+#include <fastdds/rtps/common/Guid.hpp>
+
+namespace eprosima {
+namespace discovery_server {
+
+/**
+ * Table driven codec for the dotted hex text of the GUID parts, as used in snapshots and config
+ * files. The output matches the fastdds stream operators: prefix octets are zero padded to two
+ * digits and entity octets are not. Neither direction allocates or touches a stream.
+ **/
+namespace guid_codec {
+
+//! buffer sizes, NUL included
+static const std::size_t prefix_size = 12 * 3;
+static const std::size_t entity_size = 4 * 3;
+
+//! writes the NUL terminated text into out, returns its length
+std::size_t Encode(
+        const fastdds::rtps::GuidPrefix_t& prefix,
+        char* out);
+
+std::size_t Encode(
+        const fastdds::rtps::EntityId_t& entity,
+        char* out);
+
+/**
+ * Parses the text as operator>> does: hex octets up to ff separated by dots, blanks allowed
+ * before each token and any trailing text ignored. On failure the id is set to unknown and false
+ * is returned. A null text fails.
+ **/
+bool Decode(
+        const char* text,
+        fastdds::rtps::GuidPrefix_t& prefix);
+
+bool Decode(
+        const char* text,
+        fastdds::rtps::EntityId_t& entity);
+
+} // namespace guid_codec
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _GUID_CODEC_H_
@@ -41,6 +41,9 @@ static const std::string s_sSnapshots("snapshots");
 static const std::string s_sFile("file");
 static const std::string s_sUserShutdown("user_shutdown");
 static const std::string s_sPrefixValidation("prefix_validation");
+static const std::string s_sIngestionQueue("ingestion_queue");
+static const std::string s_sStagingBuffers("staging_buffers");
+static const std::string s_sZombieGracePeriod("zombie_grace_period");
 static const std::string s_sListeningPort("listening_port");
 static const std::string s_sEnvironment("environment");
 static const std::string s_sChange("change");
@@ -70,6 +73,14 @@ static const std::string s_sAliveCount("alive_count");
 static const std::string s_sNotAliveCount("not_alive_count");
 static const std::string s_sDiscovered_timestamp("discovered_timestamp");
 
+// normalized Snapshot schema string literals
+static const std::string s_sParticipants("participants");
+static const std::string s_sParticipant("participant");
+static const std::string s_sParticipantRef("participant_ref");
+static const std::string s_sPublisherRef("publisher_ref");
+static const std::string s_sSubscriberRef("subscriber_ref");
+static const std::string s_sId("id");
+
 } // discovery_server
 } // eprosima
 
@@ -0,0 +1,136 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _INTERNED_STRING_H_
+#define _INTERNED_STRING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace eprosima {
+namespace discovery_server {
+
+//! process-wide interned string, equal strings share the same symbol id
+//! intended for the few distinct topic and type names repeated across all discovery items
+//! interning throws std::length_error once the table is full, symbols are never aliased
+class InternedString
+{
+public:
+
+    typedef uint32_t symbol_id;
+
+    //! the empty string is always symbol 0
+    InternedString()
+        : id_(0)
+    {
+    }
+
+    InternedString(
+            const std::string& s)
+        : id_(intern(s.data(), s.size()))
+    {
+    }
+
+    InternedString(
+            const char* s);
+
+    InternedString(
+            const char* s,
+            std::size_t size)
+        : id_(intern(s, size))
+    {
+    }
+
+    InternedString(
+            const InternedString&) = default;
+    InternedString& operator =(
+            const InternedString&) = default;
+
+    //! interned text, references are valid during the whole process lifetime
+    const std::string& str() const;
+
+    const char* c_str() const
+    {
+        return str().c_str();
+    }
+
+    symbol_id id() const
+    {
+        return id_;
+    }
+
+    bool empty() const
+    {
+        return id_ == 0;
+    }
+
+    //! comparisons are integer ones
+    bool operator ==(
+            const InternedString& s) const
+    {
+        return id_ == s.id_;
+    }
+
+    bool operator !=(
+            const InternedString& s) const
+    {
+        return id_ != s.id_;
+    }
+
+    //! symbol order, unrelated to the lexicographical one
+    bool operator <(
+            const InternedString& s) const
+    {
+        return id_ < s.id_;
+    }
+
+    //! number of distinct strings interned
+    static std::size_t symbols();
+
+    //! looks up a string without interning it, false if it was never interned
+    static bool Find(
+            const std::string& s,
+            InternedString& found);
+
+    static bool Find(
+            const char* s,
+            std::size_t size,
+            InternedString& found);
+
+private:
+
+    explicit InternedString(
+            symbol_id id)
+        : id_(id)
+    {
+    }
+
+    symbol_id id_;
+
+    static symbol_id intern(
+            const char* s,
+            std::size_t size);
+};
+
+std::ostream& operator <<(
+        std::ostream&,
+        const InternedString&);
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _INTERNED_STRING_H_
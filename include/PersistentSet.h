@@ -0,0 +1,490 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _PERSISTENT_SET_H_
+#define _PERSISTENT_SET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "DiscoveryArena.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+/**
+ * Ordered set whose copies share their nodes (a treap with path copying). Each node is tagged with
+ * the generation allowed to modify it in place, any other generation copies the path from the root
+ * to the node first. Copying the set takes constant time and the first modification of an element
+ * copies a logarithmic number of nodes, whatever the set size. New nodes are taken from the arena
+ * in scope. Element addresses stay valid while the modifying generation owns the node, the
+ * iterator returned by own() is the one to keep. Iterators keep the pending ancestors of their node,
+ * so increments take amortized constant time, and only the iterator returned by a modifier is valid
+ * after it.
+ **/
+template<class T, class Compare = std::less<>>
+class PersistentSet
+{
+    struct Node;
+    typedef std::shared_ptr<Node> node_ptr;
+
+    struct Node
+    {
+        template<class ... Args>
+        Node(
+                uint64_t generation,
+                uint32_t heap_priority,
+                Args&&... args)
+            : value(std::forward<Args>(args)...)
+            , priority(heap_priority)
+            , owner(generation)
+        {
+        }
+
+        //! copy for another generation, children are shared
+        Node(
+                uint64_t generation,
+                const Node& n)
+            : value(n.value)
+            , left(n.left)
+            , right(n.right)
+            , priority(n.priority)
+            , owner(generation)
+        {
+        }
+
+        T value;
+        node_ptr left;
+        node_ptr right;
+        uint32_t priority; // max heap on priorities keeps the tree balanced on average
+        uint64_t owner;    // generation allowed to modify the node in place
+    };
+
+public:
+
+    typedef T value_type;
+    typedef std::size_t size_type;
+
+    class const_iterator
+    {
+    public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        const_iterator() = default;
+
+        reference operator *() const
+        {
+            return node_->value;
+        }
+
+        pointer operator ->() const
+        {
+            return &node_->value;
+        }
+
+        //! nodes have no parent links as they are shared, the pending ancestors are kept instead
+        const_iterator& operator ++()
+        {
+            if (node_->right)
+            {
+                const Node* n = node_->right.get();
+
+                for (; n->left; n = n->left.get())
+                {
+                    push(n);
+                }
+
+                node_ = n;
+            }
+            else if (depth_ == 0 && truncated_)
+            {
+                // the farthest ancestors were dropped, the successor is searched from the root
+                *this = set_->successor(node_->value);
+            }
+            else
+            {
+                pop();
+            }
+
+            return *this;
+        }
+
+        const_iterator operator ++(
+                int)
+        {
+            const_iterator tmp(*this);
+            operator ++();
+            return tmp;
+        }
+
+        bool operator ==(
+                const const_iterator& it) const
+        {
+            return node_ == it.node_;
+        }
+
+        bool operator !=(
+                const const_iterator& it) const
+        {
+            return node_ != it.node_;
+        }
+
+    private:
+
+        friend class PersistentSet;
+
+        //! ancestors kept, deeper paths only keep the nearest ones
+        static const std::size_t path_size = 32;
+
+        explicit const_iterator(
+                const PersistentSet* set)
+            : set_(set)
+        {
+        }
+
+        //! n follows the elements still to be visited
+        void push(
+                const Node* n)
+        {
+            if (depth_ == path_size)
+            {
+                std::copy(path_ + 1, path_ + depth_, path_);
+                --depth_;
+                truncated_ = true;
+            }
+
+            path_[depth_++] = n;
+        }
+
+        //! moves to the nearest pending ancestor, end if none
+        void pop()
+        {
+            node_ = depth_ > 0 ? path_[--depth_] : nullptr;
+        }
+
+        const PersistentSet* set_ = nullptr;
+        const Node* node_ = nullptr; // null on end
+        const Node* path_[path_size]; // ancestors whose left subtree holds node_, nearest last
+        std::size_t depth_ = 0;
+        bool truncated_ = false;     // some ancestors were dropped from path_
+    };
+
+    typedef const_iterator iterator;
+
+    const_iterator begin() const
+    {
+        const_iterator it(this);
+
+        for (const Node* n = root_.get(); n != nullptr; n = n->left.get())
+        {
+            it.push(n);
+        }
+
+        it.pop();
+        return it;
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this);
+    }
+
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    size_type size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    template<class K>
+    const_iterator lower_bound(
+            const K& key) const
+    {
+        const_iterator it(this);
+
+        for (const Node* n = root_.get(); n != nullptr;)
+        {
+            if (comp_(n->value, key))
+            {
+                n = n->right.get();
+            }
+            else
+            {
+                it.push(n);
+                n = n->left.get();
+            }
+        }
+
+        // the last candidate is the bound, the previous ones follow it
+        it.pop();
+        return it;
+    }
+
+    template<class K>
+    const_iterator find(
+            const K& key) const
+    {
+        const_iterator it = lower_bound(key);
+        return it == end() || comp_(key, *it) ? end() : it;
+    }
+
+    //! inserts the element if not there, the new node is owned by the generation
+    template<class ... Args>
+    std::pair<const_iterator, bool> emplace(
+            uint64_t generation,
+            Args&&... args)
+    {
+        node_ptr fresh = make_node(generation, next_priority(), std::forward<Args>(args)...);
+        const_iterator it = find(fresh->value);
+
+        if (it != end())
+        {
+            return std::make_pair(it, false);
+        }
+
+        root_ = insert(root_, fresh, generation);
+        ++size_;
+
+        // the path changed, it is searched again
+        return std::make_pair(lower_bound(fresh->value), true);
+    }
+
+    //! removes the element, returns the iterator to the next one
+    const_iterator erase(
+            uint64_t generation,
+            const_iterator it)
+    {
+        node_ptr removed;
+        root_ = erase(root_, *it, generation, removed);
+        --size_;
+
+        // the removed node keeps the key alive for the search
+        return successor(removed->value);
+    }
+
+    //! copies the element node and its path if other generations own them, its value may be modified then
+    const_iterator own(
+            uint64_t generation,
+            const_iterator it)
+    {
+        // the ancestors of an owned node are owned too, they were copied first
+        if (it.node_->owner == generation)
+        {
+            return it;
+        }
+
+        const Node* found = nullptr;
+        root_ = touch(root_, *it, generation, found);
+
+        // the iterator path holds the copied ancestors
+        return lower_bound(found->value);
+    }
+
+private:
+
+    template<class ... Args>
+    static node_ptr make_node(
+            Args&&... args)
+    {
+        return std::allocate_shared<Node>(ArenaAllocator<Node>(), std::forward<Args>(args)...);
+    }
+
+    //! xorshift, priorities need not be reproducible
+    static uint32_t next_priority()
+    {
+        static thread_local uint32_t state = 2463534242u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+
+    //! the node itself if owned by the generation, a copy otherwise
+    static node_ptr claim(
+            const node_ptr& n,
+            uint64_t generation)
+    {
+        return n->owner == generation ? n : make_node(generation, *n);
+    }
+
+    //! first element greater than the key
+    template<class K>
+    const_iterator successor(
+            const K& key) const
+    {
+        const_iterator it(this);
+
+        for (const Node* n = root_.get(); n != nullptr;)
+        {
+            if (comp_(key, n->value))
+            {
+                it.push(n);
+                n = n->left.get();
+            }
+            else
+            {
+                n = n->right.get();
+            }
+        }
+
+        it.pop();
+        return it;
+    }
+
+    static node_ptr rotate_right(
+            const node_ptr& n)
+    {
+        node_ptr l = n->left;
+        n->left = l->right;
+        l->right = n;
+        return l;
+    }
+
+    static node_ptr rotate_left(
+            const node_ptr& n)
+    {
+        node_ptr r = n->right;
+        n->right = r->left;
+        r->left = n;
+        return r;
+    }
+
+    //! fresh is not in the tree, every node on its path ends up owned by the generation
+    node_ptr insert(
+            const node_ptr& n,
+            const node_ptr& fresh,
+            uint64_t generation)
+    {
+        if (!n)
+        {
+            return fresh;
+        }
+
+        node_ptr o = claim(n, generation);
+
+        if (comp_(fresh->value, o->value))
+        {
+            o->left = insert(o->left, fresh, generation);
+            return o->left->priority > o->priority ? rotate_right(o) : o;
+        }
+
+        o->right = insert(o->right, fresh, generation);
+        return o->right->priority > o->priority ? rotate_left(o) : o;
+    }
+
+    //! value must be in the tree
+    node_ptr erase(
+            const node_ptr& n,
+            const T& value,
+            uint64_t generation,
+            node_ptr& removed)
+    {
+        if (comp_(value, n->value))
+        {
+            node_ptr o = claim(n, generation);
+            o->left = erase(o->left, value, generation, removed);
+            return o;
+        }
+
+        if (comp_(n->value, value))
+        {
+            node_ptr o = claim(n, generation);
+            o->right = erase(o->right, value, generation, removed);
+            return o;
+        }
+
+        removed = n;
+        return merge(n->left, n->right, generation);
+    }
+
+    //! joins two subtrees, all the elements on the left one go first
+    node_ptr merge(
+            const node_ptr& l,
+            const node_ptr& r,
+            uint64_t generation)
+    {
+        if (!l || !r)
+        {
+            return l ? l : r;
+        }
+
+        if (l->priority > r->priority)
+        {
+            node_ptr o = claim(l, generation);
+            o->right = merge(o->right, r, generation);
+            return o;
+        }
+
+        node_ptr o = claim(r, generation);
+        o->left = merge(l, o->left, generation);
+        return o;
+    }
+
+    //! owns the path to the value
+    node_ptr touch(
+            const node_ptr& n,
+            const T& value,
+            uint64_t generation,
+            const Node*& found)
+    {
+        node_ptr o = claim(n, generation);
+
+        if (comp_(value, o->value))
+        {
+            o->left = touch(o->left, value, generation, found);
+        }
+        else if (comp_(o->value, value))
+        {
+            o->right = touch(o->right, value, generation, found);
+        }
+        else
+        {
+            found = o.get();
+        }
+
+        return o;
+    }
+
+    node_ptr root_;
+    size_type size_ = 0;
+    Compare comp_;
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _PERSISTENT_SET_H_
@@ -0,0 +1,240 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _SNAPSHOT_BINARY_H_
+#define _SNAPSHOT_BINARY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DiscoveryItem.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+/**
+ * Binary snapshot file layout. A header followed by four record arrays and a string table. Records
+ * keep the same info as the ds-snapshot XML elements, times in ms like the XML attributes, and
+ * reference their children by index ranges into the next array and their strings by offset into
+ * the table. All records are naturally aligned in the host byte order, little endian on every
+ * supported platform, so a mapped file can be walked in place.
+ **/
+namespace snapshot_binary {
+
+static const char magic[8] = {'D', 'S', 'S', 'N', 'A', 'P', 'B', '\0'};
+static const uint32_t version = 1;
+static const uint32_t byte_order_mark = 0x01020304; // reads differently on a foreign byte order host
+static const char extension[] = ".dssnap";
+
+//! NUL terminated string in the string table
+struct StringRef
+{
+    uint32_t offset;
+    uint32_t length; // without the NUL
+};
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t file_size;
+    uint64_t snapshots_offset;
+    uint64_t databases_offset;
+    uint64_t items_offset;
+    uint64_t endpoints_offset;
+    uint64_t strings_offset;
+    uint32_t snapshot_count;
+    uint32_t database_count;
+    uint32_t item_count;
+    uint32_t endpoint_count;
+    uint64_t strings_size;
+};
+
+//! DS_Snapshot element
+struct SnapshotRecord
+{
+    int64_t timestamp;         // ms from the POSIX epoch
+    int64_t process_time;      // ms from the process startup, as the following times
+    int64_t last_pdp_callback;
+    int64_t last_edp_callback;
+    StringRef description;
+    uint32_t first_database;
+    uint32_t database_count;
+    uint8_t someone;
+    uint8_t reserved[7];
+};
+
+//! ptdb element
+struct DatabaseRecord
+{
+    uint8_t guid[16];
+    StringRef name;
+    uint32_t first_item;
+    uint32_t item_count;
+};
+
+//! ptdi element
+struct ItemRecord
+{
+    uint8_t guid[16];
+    StringRef name;
+    int64_t discovered_timestamp;
+    uint32_t first_reader;
+    uint32_t reader_count;
+    uint32_t first_writer;
+    uint32_t writer_count;
+    uint8_t server;
+    uint8_t alive;
+    uint8_t reserved[6];
+};
+
+//! subscriber or publisher element
+struct EndpointRecord
+{
+    uint8_t guid[16];
+    StringRef type;
+    StringRef topic;
+    int64_t discovered_timestamp;
+    int32_t alive_count;     // only meaningful with liveliness
+    int32_t not_alive_count;
+    uint8_t liveliness;      // the XML element has the liveliness attributes
+    uint8_t reserved[7];
+};
+
+} // namespace snapshot_binary
+
+//! contiguous records walked in place
+template<class T>
+class RecordRange
+{
+public:
+
+    RecordRange(
+            const T* first,
+            std::size_t count)
+        : begin_(first)
+        , end_(first + count)
+    {
+    }
+
+    const T* begin() const
+    {
+        return begin_;
+    }
+
+    const T* end() const
+    {
+        return end_;
+    }
+
+    std::size_t size() const
+    {
+        return end_ - begin_;
+    }
+
+    const T& operator [](
+            std::size_t index) const
+    {
+        return begin_[index];
+    }
+
+private:
+
+    const T* begin_;
+    const T* end_;
+};
+
+/**
+ * Read only memory mapping of a binary snapshot file. The whole file is verified on construction,
+ * afterwards the records are accessed in place without any parsing or allocation.
+ **/
+class BinarySnapshotFile
+{
+public:
+
+    explicit BinarySnapshotFile(
+            const std::string& file);
+
+    ~BinarySnapshotFile();
+
+    BinarySnapshotFile(
+            const BinarySnapshotFile&) = delete;
+    BinarySnapshotFile& operator =(
+            const BinarySnapshotFile&) = delete;
+
+    //! false if the file couldn't be mapped or is not a valid binary snapshot file
+    bool Valid() const
+    {
+        return header_ != nullptr;
+    }
+
+    RecordRange<snapshot_binary::SnapshotRecord> Snapshots() const;
+    RecordRange<snapshot_binary::DatabaseRecord> Databases(
+            const snapshot_binary::SnapshotRecord& snapshot) const;
+    RecordRange<snapshot_binary::ItemRecord> Items(
+            const snapshot_binary::DatabaseRecord& database) const;
+    RecordRange<snapshot_binary::EndpointRecord> Readers(
+            const snapshot_binary::ItemRecord& item) const;
+    RecordRange<snapshot_binary::EndpointRecord> Writers(
+            const snapshot_binary::ItemRecord& item) const;
+
+    //! NUL terminated, lives as long as the mapping
+    const char* String(
+            const snapshot_binary::StringRef& ref) const;
+
+    static GUID_t Guid(
+            const uint8_t (&guid)[16]);
+
+    //! rebuilds the snapshot exactly as Snapshot::from_xml would from the equivalent XML, on an arena of its own
+    Snapshot ToSnapshot(
+            const snapshot_binary::SnapshotRecord& snapshot) const;
+
+    //! checks the file magic only
+    static bool Probe(
+            const std::string& file);
+
+private:
+
+    //! bounds checks all the records
+    bool verify() const;
+
+    template<class T>
+    const T* array(
+            uint64_t offset) const
+    {
+        return reinterpret_cast<const T*>(data_ + offset);
+    }
+
+    const uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    const snapshot_binary::FileHeader* header_ = nullptr; // null if not valid
+};
+
+//! writes the snapshots as a binary snapshot file
+bool SaveBinarySnapshots(
+        const std::string& file,
+        const std::vector<Snapshot>& snapshots);
+
+//! binary snapshot files are recognized by the .dssnap extension
+bool HasBinarySnapshotExtension(
+        const std::string& file);
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _SNAPSHOT_BINARY_H_
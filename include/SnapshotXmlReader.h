@@ -0,0 +1,80 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _SNAPSHOT_XML_READER_H_
+#define _SNAPSHOT_XML_READER_H_
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "DiscoveryItem.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+//! selects the snapshots to load by description, a null filter loads them all
+typedef std::function<bool(const std::string& description)> SnapshotFilter;
+
+/**
+ * Event driven ds-snapshot XML loader. Each Snapshot is built while its elements are read, as
+ * Snapshot::from_xml would, without loading the document. The content of the snapshots rejected
+ * by the filter is scanned but never built. Snapshots in the normalized encoding are expanded
+ * through their participants table, both encodings may be mixed in a file.
+ **/
+class SnapshotXmlReader
+{
+public:
+
+    explicit SnapshotXmlReader(
+            SnapshotFilter filter = nullptr);
+
+    //! appends the selected snapshots on an arena of their own, false on malformed XML or a wrong root element
+    bool Load(
+            std::istream& in,
+            std::vector<Snapshot>& snapshots);
+
+    bool Load(
+            const std::string& file,
+            std::vector<Snapshot>& snapshots);
+
+    //! checks the root element only
+    static bool Probe(
+            const std::string& file);
+
+    //! description of the last failure
+    const std::string& Error() const
+    {
+        return error_;
+    }
+
+    //! number of snapshots skipped by the filter
+    std::size_t Skipped() const
+    {
+        return skipped_;
+    }
+
+private:
+
+    SnapshotFilter filter_;
+    std::string error_;
+    std::size_t skipped_ = 0;
+};
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _SNAPSHOT_XML_READER_H_
@@ -0,0 +1,137 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef _SNAPSHOT_XML_WRITER_H_
+#define _SNAPSHOT_XML_WRITER_H_
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DiscoveryItem.h"
+
+namespace eprosima {
+namespace discovery_server {
+
+/**
+ * Writes ds-snapshot XML element by element to an output stream. The output is byte for byte the
+ * one tinyxml2 saves for the document Snapshot::to_xml builds, but no DOM is kept, so the memory
+ * used doesn't depend on the snapshots size.
+ *
+ * The normalized encoding lists each participant and endpoint once per snapshot in a participants
+ * table. Each ptdb then references the table rows, only adding its discovery timestamps and the
+ * values that differ from the row, so the file no longer grows as the square of the participants.
+ **/
+class SnapshotXmlWriter
+{
+public:
+
+    explicit SnapshotXmlWriter(
+            std::ostream& out,
+            bool normalized = false);
+
+    //! xml declaration and DS_Snapshots root element opening
+    void Begin();
+
+    //! a DS_Snapshot element
+    void Write(
+            const Snapshot& sh);
+
+    //! closes the root element
+    void End();
+
+private:
+
+    // tinyxml2::XMLPrinter formatting
+    void open(
+            const std::string& name);
+    void attribute(
+            const std::string& name,
+            const char* value);
+    void attribute(
+            const std::string& name,
+            int64_t value);
+    void attribute(
+            const std::string& name,
+            bool value);
+    template<class Id>
+    void attribute_id(
+            const std::string& name,
+            const Id& id);
+    void text(
+            const char* value);
+    void close();
+
+    void seal();
+    void new_line();
+    void escape(
+            const char* value,
+            bool text);
+
+    // normalized encoding
+    void write_table(
+            const Snapshot& sh);
+    void write_references(
+            const Snapshot& sh,
+            const ParticipantDiscoveryDatabase& discovery_database);
+    void add_endpoint(
+            std::size_t participant,
+            const GUID_t& guid,
+            const InternedString& type,
+            const InternedString& topic,
+            bool reader);
+
+    //! first occurrence of a participant, the references only override what differs
+    struct ParticipantRow
+    {
+        const ParticipantDiscoveryItem* item;
+        std::vector<std::size_t> endpoints; // into endpoints_, in the table order
+    };
+
+    struct EndpointRow
+    {
+        GUID_t guid;
+        InternedString type;
+        InternedString topic;
+        bool reader;
+        int64_t id; // table position
+    };
+
+    std::ostream& out_;
+    bool normalized_;
+    // table of the snapshot being written, kept to reuse its memory
+    std::vector<ParticipantRow> participants_;
+    std::vector<EndpointRow> endpoints_;
+    std::unordered_map<GUID_t, std::size_t, GUIDHash> participant_rows_;
+    std::unordered_map<GUID_t, std::size_t, GUIDHash> endpoint_rows_;
+    std::vector<const std::string*> stack_; // open elements
+    int depth_ = 0;
+    int text_depth_ = -1; // depth of the element holding text, no indentation inside
+    bool just_opened_ = false; // the start tag is not yet closed with >
+    bool first_ = true;
+};
+
+//! saves the snapshots as an XML file through a buffered stream
+bool SaveXmlSnapshots(
+        const std::string& file,
+        const std::vector<Snapshot>& snapshots,
+        bool normalized = false);
+
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _SNAPSHOT_XML_WRITER_H_
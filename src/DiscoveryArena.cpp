@@ -0,0 +1,138 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+
+#include "DiscoveryArena.h"
+
+using namespace eprosima::discovery_server;
+
+namespace {
+
+std::atomic<uint64_t> s_nodes(0);
+std::atomic<uint64_t> s_chunks(0);
+std::atomic<uint64_t> s_oversized(0);
+
+//! arena selected by the innermost ArenaScope of each thread
+thread_local DiscoveryArena* s_current = nullptr;
+
+//! process default arena, never released because static containers may outlive it
+DiscoveryArena& default_arena()
+{
+    static std::shared_ptr<DiscoveryArena>* arena = new std::shared_ptr<DiscoveryArena>(
+        std::make_shared<DiscoveryArena>());
+    return **arena;
+}
+
+//! free list of the smallest node size that fits the bytes, zero bytes take the smallest node
+std::size_t slot_of(
+        std::size_t bytes)
+{
+    return bytes == 0 ? 0 : (bytes + DiscoveryArena::granularity - 1) / DiscoveryArena::granularity - 1;
+}
+
+} // namespace
+
+DiscoveryArena::~DiscoveryArena()
+{
+    // all the nodes are released at once
+    for (void* chunk : chunks_)
+    {
+        ::operator delete(chunk);
+    }
+}
+
+void* DiscoveryArena::allocate(
+        std::size_t bytes)
+{
+    if (bytes > max_node_size)
+    {
+        ++s_oversized;
+        return ::operator new(bytes);
+    }
+
+    std::size_t slot = slot_of(bytes);
+    ++s_nodes;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    FreeNode* node = free_[slot];
+    if (node != nullptr)
+    {
+        free_[slot] = node->next;
+        return node;
+    }
+
+    std::size_t size = (slot + 1) * granularity;
+
+    if (static_cast<std::size_t>(end_ - cursor_) < size)
+    {
+        // the chunk tail is wasted, it is smaller than a node
+        chunks_.reserve(chunks_.size() + 1);
+        cursor_ = static_cast<char*>(::operator new(chunk_size));
+        end_ = cursor_ + chunk_size;
+        chunks_.push_back(cursor_);
+        ++s_chunks;
+    }
+
+    void* p = cursor_;
+    cursor_ += size;
+    return p;
+}
+
+void DiscoveryArena::deallocate(
+        void* p,
+        std::size_t bytes)
+{
+    if (bytes > max_node_size)
+    {
+        ::operator delete(p);
+        return;
+    }
+
+    std::size_t slot = slot_of(bytes);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    FreeNode* node = static_cast<FreeNode*>(p);
+    node->next = free_[slot];
+    free_[slot] = node;
+}
+
+std::shared_ptr<DiscoveryArena> DiscoveryArena::current()
+{
+    return s_current != nullptr ? s_current->shared_from_this() : default_arena().shared_from_this();
+}
+
+DiscoveryArena::Statistics DiscoveryArena::statistics()
+{
+    Statistics stats;
+    stats.nodes = s_nodes;
+    stats.chunks = s_chunks;
+    stats.oversized = s_oversized;
+    return stats;
+}
+
+ArenaScope::ArenaScope(
+        std::shared_ptr<DiscoveryArena> arena)
+    : arena_(std::move(arena))
+    , previous_(s_current)
+{
+    s_current = arena_.get();
+}
+
+ArenaScope::~ArenaScope()
+{
+    s_current = previous_;
+}
@@ -0,0 +1,358 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "DiscoveryEventQueue.h"
+
+using namespace eprosima::discovery_server;
+
+// discovery event factories
+
+DiscoveryEvent DiscoveryEvent::AddParticipant(
+        const GUID_t& spokesman,
+        const InternedString& srcName,
+        const GUID_t& ptid,
+        std::string name,
+        const std::chrono::steady_clock::time_point& discovered_timestamp,
+        bool server)
+{
+    DiscoveryEvent e;
+    e.kind = Kind::ADD_PARTICIPANT;
+    e.spokesman = spokesman;
+    e.spokesman_name = srcName;
+    e.participant = ptid;
+    e.participant_name = std::move(name);
+    e.timestamp = discovered_timestamp;
+    e.server = server;
+    return e;
+}
+
+DiscoveryEvent DiscoveryEvent::RemoveParticipant(
+        const GUID_t& spokesman,
+        const GUID_t& ptid)
+{
+    DiscoveryEvent e;
+    e.kind = Kind::REMOVE_PARTICIPANT;
+    e.spokesman = spokesman;
+    e.participant = ptid;
+    return e;
+}
+
+DiscoveryEvent DiscoveryEvent::AddDataReader(
+        const GUID_t& spokesman,
+        const InternedString& srcName,
+        const GUID_t& ptid,
+        const GUID_t& sid,
+        const InternedString& _typename,
+        const InternedString& topicname,
+        const std::chrono::steady_clock::time_point& discovered_timestamp)
+{
+    DiscoveryEvent e;
+    e.kind = Kind::ADD_DATAREADER;
+    e.spokesman = spokesman;
+    e.spokesman_name = srcName;
+    e.participant = ptid;
+    e.endpoint = sid;
+    e.type_name = _typename;
+    e.topic_name = topicname;
+    e.timestamp = discovered_timestamp;
+    return e;
+}
+
+DiscoveryEvent DiscoveryEvent::RemoveDataReader(
+        const GUID_t& spokesman,
+        const GUID_t& ptid,
+        const GUID_t& sid)
+{
+    DiscoveryEvent e;
+    e.kind = Kind::REMOVE_DATAREADER;
+    e.spokesman = spokesman;
+    e.participant = ptid;
+    e.endpoint = sid;
+    return e;
+}
+
+DiscoveryEvent DiscoveryEvent::AddDataWriter(
+        const GUID_t& spokesman,
+        const InternedString& srcName,
+        const GUID_t& ptid,
+        const GUID_t& pid,
+        const InternedString& _typename,
+        const InternedString& topicname,
+        const std::chrono::steady_clock::time_point& discovered_timestamp)
+{
+    DiscoveryEvent e = AddDataReader(spokesman, srcName, ptid, pid, _typename, topicname, discovered_timestamp);
+    e.kind = Kind::ADD_DATAWRITER;
+    return e;
+}
+
+DiscoveryEvent DiscoveryEvent::RemoveDataWriter(
+        const GUID_t& spokesman,
+        const GUID_t& ptid,
+        const GUID_t& pid)
+{
+    DiscoveryEvent e = RemoveDataReader(spokesman, ptid, pid);
+    e.kind = Kind::REMOVE_DATAWRITER;
+    return e;
+}
+
+DiscoveryEvent DiscoveryEvent::UpdateSubLiveliness(
+        const GUID_t& subs,
+        int32_t alive_count,
+        int32_t not_alive_count)
+{
+    DiscoveryEvent e;
+    e.kind = Kind::UPDATE_LIVELINESS;
+    e.endpoint = subs;
+    e.alive_count = alive_count;
+    e.not_alive_count = not_alive_count;
+    return e;
+}
+
+bool DiscoveryEvent::apply(
+        DiscoveryItemDatabase& database)
+{
+    switch (kind)
+    {
+        case Kind::ADD_PARTICIPANT:
+            return database.AddParticipant(spokesman, spokesman_name.str(), participant, std::move(participant_name),
+                           timestamp, server);
+        case Kind::REMOVE_PARTICIPANT:
+            return database.RemoveParticipant(spokesman, participant);
+        case Kind::ADD_DATAREADER:
+            return database.AddDataReader(spokesman, spokesman_name.str(), participant, endpoint,
+                           type_name, topic_name, timestamp);
+        case Kind::REMOVE_DATAREADER:
+            return database.RemoveDataReader(spokesman, participant, endpoint);
+        case Kind::ADD_DATAWRITER:
+            return database.AddDataWriter(spokesman, spokesman_name.str(), participant, endpoint,
+                           type_name, topic_name, timestamp);
+        case Kind::REMOVE_DATAWRITER:
+            return database.RemoveDataWriter(spokesman, participant, endpoint);
+        case Kind::UPDATE_LIVELINESS:
+            database.UpdateSubLiveliness(endpoint, alive_count, not_alive_count);
+            return true;
+    }
+
+    return false;
+}
+
+std::ostream& eprosima::discovery_server::operator <<(
+        std::ostream& os,
+        const DiscoveryIngestion& ingestion)
+{
+    ingestion.report(os);
+    return os;
+}
+
+// event queue operations
+
+DiscoveryEventQueue::DiscoveryEventQueue(
+        DiscoveryItemDatabase& database,
+        std::size_t capacity)
+    : database_(database)
+{
+    std::size_t size = 2;
+    while (size < capacity)
+    {
+        size <<= 1;
+    }
+
+    cells_.reset(new Cell[size]);
+    mask_ = size - 1;
+
+    // each cell sequence tells the position it is expected to be written at
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    applier_ = std::thread(&DiscoveryEventQueue::run, this);
+}
+
+DiscoveryEventQueue::~DiscoveryEventQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+
+    wakeup_.notify_one();
+    applier_.join();
+}
+
+void DiscoveryEventQueue::push(
+        DiscoveryEvent&& event)
+{
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    bool full = false;
+    Cell* cell;
+
+    for (;;)
+    {
+        cell = &cells_[pos & mask_];
+        uint64_t seq = cell->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+
+        if (diff == 0)
+        {
+            // cell free, claim the position
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (diff < 0)
+        {
+            // queue full, wait for the applier
+            if (!full)
+            {
+                full = true;
+                ++backpressure_;
+            }
+
+            std::this_thread::yield();
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+        else
+        {
+            // other producer claimed it
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->event = std::move(event);
+
+    // sequentially consistent publication, either the applier sees the event or we see it sleeping
+    cell->sequence.store(pos + 1);
+
+    if (sleeping_.load())
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeup_.notify_one();
+    }
+}
+
+void DiscoveryEventQueue::flush()
+{
+    uint64_t target = enqueue_pos_.load(std::memory_order_acquire);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    applied_cv_.wait(lock, [&]()
+            {
+                return applied_.load() >= target;
+            });
+}
+
+DiscoveryEventQueue::Statistics DiscoveryEventQueue::statistics() const
+{
+    Statistics stats;
+    stats.applied = applied_;
+    stats.enqueued = enqueue_pos_;
+    stats.depth = stats.enqueued > stats.applied ? stats.enqueued - stats.applied : 0;
+    stats.max_depth = max_depth_;
+    stats.batches = batches_;
+    stats.backpressure = backpressure_;
+    return stats;
+}
+
+void DiscoveryEventQueue::report(
+        std::ostream& os) const
+{
+    Statistics stats = statistics();
+    os << "queue applied " << stats.applied << " of " << stats.enqueued << " events in " << stats.batches
+       << " batches, max depth " << stats.max_depth << ", backpressure " << stats.backpressure;
+}
+
+bool DiscoveryEventQueue::ready() const
+{
+    const Cell& cell = cells_[dequeue_pos_ & mask_];
+    return cell.sequence.load() == dequeue_pos_ + 1;
+}
+
+bool DiscoveryEventQueue::pop(
+        DiscoveryEvent& event)
+{
+    if (!ready())
+    {
+        return false;
+    }
+
+    Cell& cell = cells_[dequeue_pos_ & mask_];
+    event = std::move(cell.event);
+
+    // release the cell for the position a lap ahead
+    cell.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+    ++dequeue_pos_;
+
+    return true;
+}
+
+void DiscoveryEventQueue::run()
+{
+    std::vector<DiscoveryEvent> batch;
+    batch.reserve(max_batch);
+
+    for (;;)
+    {
+        uint64_t depth = enqueue_pos_.load(std::memory_order_relaxed) - dequeue_pos_;
+        if (depth > max_depth_.load(std::memory_order_relaxed))
+        {
+            max_depth_.store(depth, std::memory_order_relaxed);
+        }
+
+        DiscoveryEvent event;
+        while (batch.size() < max_batch && pop(event))
+        {
+            batch.push_back(std::move(event));
+        }
+
+        if (batch.empty())
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+
+            if (stop_ && enqueue_pos_.load() == dequeue_pos_)
+            {
+                return; // all pushed events applied
+            }
+
+            // pairs with the producers publication
+            sleeping_.store(true);
+
+            // the timeout covers producers preempted between claiming and publishing a cell
+            wakeup_.wait_for(lock, std::chrono::milliseconds(10), [this]()
+                    {
+                        return stop_ || ready();
+                    });
+
+            sleeping_.store(false);
+            continue;
+        }
+
+        for (DiscoveryEvent& e : batch)
+        {
+            e.apply(database_);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            applied_ += batch.size();
+            ++batches_;
+        }
+
+        applied_cv_.notify_all();
+        batch.clear();
+    }
+}
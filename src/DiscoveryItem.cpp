@@ -13,16 +13,17 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
-#include <numeric>
 #include <sstream>
 
 #include <tinyxml2.h>
 
 #include "DiscoveryItem.h"
+#include "GuidCodec.h"
 #include "IDs.h"
 #include "log/DSLog.h"
 
@@ -34,6 +35,26 @@
 using namespace eprosima::fastdds;
 using namespace eprosima::discovery_server;
 
+// GUID hashing (FNV-1a over prefix and entity id bytes)
+
+std::size_t GUIDHash::operator ()(
+        const GUID_t& guid) const
+{
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (rtps::octet o : guid.guidPrefix.value)
+    {
+        hash = (hash ^ o) * 1099511628211ULL;
+    }
+
+    for (rtps::octet o : guid.entityId.value)
+    {
+        hash = (hash ^ o) * 1099511628211ULL;
+    }
+
+    return static_cast<std::size_t>(hash);
+}
+
 // basic discovery items operations
 
 bool DiscoveryItem::operator ==(
@@ -72,6 +93,13 @@ bool DiscoveryItem::operator <(
     return endpoint_guid < d.endpoint_guid;
 }
 
+bool eprosima::discovery_server::operator <(
+        const GUID_t& guid,
+        const DiscoveryItem& d)
+{
+    return guid < d.endpoint_guid;
+}
+
 // DataWriter discovery item operations
 bool DataWriterDiscoveryItem::operator ==(
         const DataWriterDiscoveryItem& p) const
@@ -113,16 +141,60 @@ bool ParticipantDiscoveryItem::operator ==(
         const ParticipantDiscoveryItem& p) const
 {
     return DiscoveryItem::operator ==(p)
-           && this->datawriters == p.datawriters
-           && this->datareaders == p.datareaders;
+           && (endpoints_ == p.endpoints_
+           || (getDataWriters() == p.getDataWriters()
+           && getDataReaders() == p.getDataReaders()));
 }
 
 bool ParticipantDiscoveryItem::operator !=(
         const ParticipantDiscoveryItem& p) const
 {
-    return DiscoveryItem::operator !=(p)
-           || this->datawriters != p.datawriters
-           || this->datareaders != p.datareaders;
+    return !(*this == p);
+}
+
+const ParticipantDiscoveryItem::publisher_set& ParticipantDiscoveryItem::getDataWriters() const
+{
+    static const publisher_set empty;
+    return endpoints_ ? endpoints_->datawriters : empty;
+}
+
+const ParticipantDiscoveryItem::subscriber_set& ParticipantDiscoveryItem::getDataReaders() const
+{
+    static const subscriber_set empty;
+    return endpoints_ ? endpoints_->datareaders : empty;
+}
+
+ParticipantDiscoveryItem::Endpoints& ParticipantDiscoveryItem::ownEndpoints(
+        uint64_t generation) const
+{
+    // STL makes iterator const to prevent that any key changing unsorts the container
+    ParticipantDiscoveryItem& part = const_cast<ParticipantDiscoveryItem&>(*this);
+
+    if (!endpoints_)
+    {
+        part.endpoints_ = std::allocate_shared<Endpoints>(ArenaAllocator<Endpoints>());
+        part.endpoints_owner_ = generation;
+    }
+    else if (endpoints_owner_ != generation)
+    {
+        // other database generations share them, copy
+        part.endpoints_ = std::allocate_shared<Endpoints>(ArenaAllocator<Endpoints>(), *endpoints_);
+        part.endpoints_owner_ = generation;
+    }
+
+    return *part.endpoints_;
+}
+
+ParticipantDiscoveryItem::publisher_set& ParticipantDiscoveryItem::getDataWriters(
+        uint64_t generation) const
+{
+    return ownEndpoints(generation).datawriters;
+}
+
+ParticipantDiscoveryItem::subscriber_set& ParticipantDiscoveryItem::getDataReaders(
+        uint64_t generation) const
+{
+    return ownEndpoints(generation).datareaders;
 }
 
 std::ostream& eprosima::discovery_server::operator <<(
@@ -143,21 +215,21 @@ std::ostream& eprosima::discovery_server::operator <<(
         os << " has:" << std::endl;
     }
 
-    if (di.datawriters.size())
+    if (di.CountDataWriters())
     {
-        os << "\t\t" << di.datawriters.size() << " datawriters:" << std::endl;
+        os << "\t\t" << di.CountDataWriters() << " datawriters:" << std::endl;
 
-        for ( const DataWriterDiscoveryItem& pdi : di.datawriters )
+        for ( const DataWriterDiscoveryItem& pdi : di.getDataWriters() )
         {
             os << "\t\t\t" << pdi << std::endl;
         }
     }
 
-    if (di.datareaders.size())
+    if (di.CountDataReaders())
     {
-        os << "\t\t" << di.datareaders.size() << " datareaders:" << std::endl;
+        os << "\t\t" << di.CountDataReaders() << " datareaders:" << std::endl;
 
-        for (const DataReaderDiscoveryItem& sdi : di.datareaders)
+        for (const DataReaderDiscoveryItem& sdi : di.getDataReaders())
         {
             os << "\t\t\t" << sdi << std::endl;
         }
@@ -170,14 +242,14 @@ bool ParticipantDiscoveryItem::operator [](
         const DataWriterDiscoveryItem& p) const
 {
     // search the list
-    return datawriters.end() != datawriters.find(p);
+    return getDataWriters().end() != getDataWriters().find(p);
 }
 
 bool ParticipantDiscoveryItem::operator [](
         const DataReaderDiscoveryItem& p) const
 {
     // search the list
-    return datareaders.end() != datareaders.find(p);
+    return getDataReaders().end() != getDataReaders().find(p);
 }
 
 void ParticipantDiscoveryItem::acknowledge(
@@ -186,22 +258,68 @@ void ParticipantDiscoveryItem::acknowledge(
     // STL makes iterator const to prevent that any key changing unsorts the container
     // so we introduce this method to avoid constant ugly const_cast use
     ParticipantDiscoveryItem& part = const_cast<ParticipantDiscoveryItem&>(*this);
+
+    if (part.is_alive && !alive)
+    {
+        part.zombie_since_ = std::chrono::steady_clock::now();
+    }
+
     part.is_alive = alive;
 }
 
 ParticipantDiscoveryItem::size_type ParticipantDiscoveryItem::CountDataReaders() const
 {
-    return datareaders.size();
+    return endpoints_ ? endpoints_->datareaders.size() : 0;
 }
 
 ParticipantDiscoveryItem::size_type ParticipantDiscoveryItem::CountDataWriters() const
 {
-    return datawriters.size();
+    return endpoints_ ? endpoints_->datawriters.size() : 0;
 }
 
 ParticipantDiscoveryItem::size_type ParticipantDiscoveryItem::CountEndpoints() const
 {
-    return datawriters.size() + datareaders.size();
+    return CountDataWriters() + CountDataReaders();
+}
+
+// participant discovery database operations
+
+namespace {
+
+//! each participants info copy gets a new generation
+uint64_t next_generation()
+{
+    static std::atomic<uint64_t> generation{0};
+    return ++generation;
+}
+
+} // namespace
+
+ParticipantDiscoveryDatabase::Body::Body()
+    : generation(next_generation())
+{
+}
+
+ParticipantDiscoveryDatabase::Body::Body(
+        const Body& b)
+    : participants(b.participants)
+    , counters(b.counters)
+    , generation(next_generation())
+{
+}
+
+void ParticipantDiscoveryDatabase::detach()
+{
+    if (shared())
+    {
+        // other copies keep the old info alive till they release it, the nodes are copied once modified
+        body_ = std::make_shared<Body>(*body_);
+    }
+    else
+    {
+        // the last copy released may have been reading on another thread
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
 }
 
 ParticipantDiscoveryDatabase::size_type ParticipantDiscoveryDatabase::CountParticipants() const
@@ -209,24 +327,39 @@ ParticipantDiscoveryDatabase::size_type ParticipantDiscoveryDatabase::CountParti
     return size();
 }
 
+ParticipantDiscoveryDatabase::size_type ParticipantDiscoveryDatabase::CountZombies() const
+{
+    return counters().zombies;
+}
+
 ParticipantDiscoveryDatabase::size_type ParticipantDiscoveryDatabase::CountDataReaders() const
 {
-    return std::accumulate(begin(), end(), size_type(0),
-                   [](size_type subs, const ParticipantDiscoveryItem& part)
-                   {
-                       return subs + part.CountDataReaders();
-                   }
-                   );
+    return counters().readers;
 }
 
 ParticipantDiscoveryDatabase::size_type ParticipantDiscoveryDatabase::CountDataWriters() const
 {
-    return std::accumulate(begin(), end(), size_type(0),
-                   [](size_type pubs, const ParticipantDiscoveryItem& part)
-                   {
-                       return pubs + part.CountDataWriters();
-                   }
-                   );
+    return counters().writers;
+}
+
+void ParticipantDiscoveryDatabase::account(
+        const ParticipantDiscoveryItem& item,
+        bool add)
+{
+    Counters& c = body_->counters;
+
+    if (add)
+    {
+        ++(item.is_alive ? c.alive : c.zombies);
+        c.writers += item.CountDataWriters();
+        c.readers += item.CountDataReaders();
+    }
+    else
+    {
+        --(item.is_alive ? c.alive : c.zombies);
+        c.writers -= item.CountDataWriters();
+        c.readers -= item.CountDataReaders();
+    }
 }
 
 std::ostream& eprosima::discovery_server::operator <<(
@@ -258,7 +391,8 @@ ParticipantDiscoveryDatabase::smart_iterator ParticipantDiscoveryDatabase::send(
 
 ParticipantDiscoveryDatabase::size_type ParticipantDiscoveryDatabase::real_size() const
 {
-    return std::distance(sbegin(), send());
+    // zombies are skipped by the smart iterators
+    return counters().alive;
 }
 
 ParticipantDiscoveryDatabase::smart_iterator::smart_iterator(
@@ -277,101 +411,695 @@ ParticipantDiscoveryDatabase::smart_iterator ParticipantDiscoveryDatabase::smart
 {
     do
     {
-        ++wrap_it_;
+        ++wrap_it_;
+    }
+    while ( wrap_it_ != ref_cont_.end() && !wrap_it_->is_alive );
+
+    return *this;
+}
+
+ParticipantDiscoveryDatabase::smart_iterator ParticipantDiscoveryDatabase::smart_iterator::operator ++(
+        int)
+{
+    smart_iterator tmp(*this);
+
+    operator ++();
+
+    return tmp;
+}
+
+ParticipantDiscoveryDatabase::smart_iterator::reference ParticipantDiscoveryDatabase::smart_iterator::operator *() const
+{
+    return (reference) * wrap_it_;
+}
+
+ParticipantDiscoveryDatabase::smart_iterator::pointer ParticipantDiscoveryDatabase::smart_iterator::operator ->() const
+{
+    return &(**this);
+}
+
+bool ParticipantDiscoveryDatabase::smart_iterator::operator ==(
+        const smart_iterator& it) const
+{
+    // note that zombies are skipped, that simplifies comparison
+    return wrap_it_ == it.wrap_it_;
+}
+
+bool ParticipantDiscoveryDatabase::smart_iterator::operator !=(
+        const smart_iterator& it) const
+{
+    // note that zombies are skipped, that simplifies comparison
+    return !(*this == it);
+}
+
+ParticipantDiscoveryDatabase::smart_iterator ParticipantDiscoveryDatabase::smart_iterator::end() const
+{
+    // the end iterator matches the wrapped iterator one
+    smart_iterator tmp(ref_cont_);
+    tmp.wrap_it_ = ref_cont_.end();
+    return tmp;
+}
+
+// acceptable snapshot misalignment in ms
+std::chrono::milliseconds Snapshot::acceptable_offset_ = std::chrono::milliseconds(400);
+
+// Time conversion auxiliary
+std::chrono::system_clock::time_point Snapshot::_system_clock(std::chrono::system_clock::now());
+std::chrono::steady_clock::time_point Snapshot::_steady_clock(std::chrono::steady_clock::now());
+
+std::chrono::system_clock::time_point Snapshot::getSystemTime(
+        std::chrono::steady_clock::time_point tp)
+{
+    using namespace std::chrono;
+
+    return _system_clock + duration_cast<system_clock::duration>(tp - _steady_clock);
+}
+
+std::string Snapshot::getTimeStamp(
+        std::chrono::steady_clock::time_point snap_time)
+{
+    std::chrono::system_clock::time_point tp = Snapshot::getSystemTime(snap_time);
+    std::time_t time = std::chrono::system_clock::to_time_t(tp);
+    std::chrono::milliseconds ms =
+            std::chrono::duration_cast<std::chrono::milliseconds>(tp - std::chrono::system_clock::from_time_t(time));
+
+    std::ostringstream stream;
+    stream << std::put_time(localtime(&time), "%F %T.") << std::setw(3) << std::setfill('0') << ms.count() << " ";
+
+    return stream.str();
+}
+
+// topic index operations
+
+TopicIndex::Stripe::Stripe()
+    : arena(std::make_shared<DiscoveryArena>())
+{
+    // containers keep the arena in scope when constructed, nested ones are created on insertions
+    ArenaScope scope(arena);
+    topics = topic_map();
+    unmatched = decltype(unmatched)();
+}
+
+TopicIndex::Stripe& TopicIndex::stripe(
+        const InternedString& topic)
+{
+    return stripes_[topic.id() % stripe_count];
+}
+
+const TopicIndex::Stripe& TopicIndex::stripe(
+        const InternedString& topic) const
+{
+    return stripes_[topic.id() % stripe_count];
+}
+
+void TopicIndex::Add(
+        endpoint_map Entry::* side,
+        const topic_key& key,
+        const GUID_t& spokesman,
+        const GUID_t& endpoint)
+{
+    Stripe& st = stripe(key.first);
+    std::lock_guard<std::mutex> lock(st.mutex);
+    ArenaScope scope(st.arena);
+
+    topic_map::iterator it = st.topics.lower_bound(key);
+
+    if (it == st.topics.end() || it->first != key)
+    {
+        it = st.topics.emplace_hint(it, key, Entry());
+    }
+
+    ((it->second).*side)[endpoint].insert(spokesman);
+    Update(st, it);
+}
+
+void TopicIndex::Remove(
+        endpoint_map Entry::* side,
+        const topic_key& key,
+        const GUID_t& spokesman,
+        const GUID_t& endpoint)
+{
+    Stripe& st = stripe(key.first);
+    std::lock_guard<std::mutex> lock(st.mutex);
+
+    topic_map::iterator it = st.topics.find(key);
+
+    if (it == st.topics.end())
+    {
+        return;
+    }
+
+    endpoint_map& endpoints = (it->second).*side;
+    endpoint_map::iterator eit = endpoints.find(endpoint);
+
+    if (eit == endpoints.end())
+    {
+        return;
+    }
+
+    eit->second.erase(spokesman);
+
+    if (eit->second.empty())
+    {
+        // no spokesman knows about it any longer
+        endpoints.erase(eit);
+        Update(st, it);
+    }
+}
+
+void TopicIndex::Update(
+        Stripe& stripe,
+        topic_map::iterator it)
+{
+    const Entry& entry = it->second;
+
+    if (entry.writers.empty() && entry.readers.empty())
+    {
+        stripe.unmatched.erase(it->first);
+        stripe.topics.erase(it);
+    }
+    else if (entry.writers.empty() || entry.readers.empty())
+    {
+        stripe.unmatched.insert(it->first);
+    }
+    else
+    {
+        stripe.unmatched.erase(it->first);
+    }
+}
+
+void TopicIndex::Report(
+        const endpoint_map& endpoints,
+        const InternedString& type_name,
+        std::vector<TopicEndpoint>& result)
+{
+    for (const endpoint_map::value_type& endpoint : endpoints)
+    {
+        TopicEndpoint info;
+        info.endpoint = endpoint.first;
+        info.type_name = type_name;
+        info.spokesmen.assign(endpoint.second.begin(), endpoint.second.end());
+        result.push_back(std::move(info));
+    }
+}
+
+void TopicIndex::Add(
+        const GUID_t& spokesman,
+        const DataWriterDiscoveryItem& writer)
+{
+    Add(&Entry::writers, topic_key(writer.topic_name, writer.type_name), spokesman, writer.endpoint_guid);
+}
+
+void TopicIndex::Add(
+        const GUID_t& spokesman,
+        const DataReaderDiscoveryItem& reader)
+{
+    Add(&Entry::readers, topic_key(reader.topic_name, reader.type_name), spokesman, reader.endpoint_guid);
+}
+
+void TopicIndex::Remove(
+        const GUID_t& spokesman,
+        const DataWriterDiscoveryItem& writer)
+{
+    Remove(&Entry::writers, topic_key(writer.topic_name, writer.type_name), spokesman, writer.endpoint_guid);
+}
+
+void TopicIndex::Remove(
+        const GUID_t& spokesman,
+        const DataReaderDiscoveryItem& reader)
+{
+    Remove(&Entry::readers, topic_key(reader.topic_name, reader.type_name), spokesman, reader.endpoint_guid);
+}
+
+void TopicIndex::Remove(
+        const ParticipantDiscoveryDatabase& database)
+{
+    const GUID_t& spokesman = database.endpoint_guid;
+
+    for (const ParticipantDiscoveryItem& participant : database)
+    {
+        for (const DataWriterDiscoveryItem& writer : participant.getDataWriters())
+        {
+            Remove(spokesman, writer);
+        }
+
+        for (const DataReaderDiscoveryItem& reader : participant.getDataReaders())
+        {
+            Remove(spokesman, reader);
+        }
+    }
+}
+
+TopicMatches TopicIndex::Query(
+        const InternedString& topic) const
+{
+    TopicMatches matches;
+
+    const Stripe& st = stripe(topic);
+    std::lock_guard<std::mutex> lock(st.mutex);
+
+    // the empty type is the first symbol, all the topic types follow
+    for (topic_map::const_iterator it = st.topics.lower_bound(topic_key(topic, InternedString()));
+            it != st.topics.end() && it->first.first == topic; ++it)
+    {
+        const Entry& entry = it->second;
+        const InternedString& type_name = it->first.second;
+
+        if (entry.writers.empty() || entry.readers.empty())
+        {
+            Report(entry.writers, type_name, matches.unmatched_writers);
+            Report(entry.readers, type_name, matches.unmatched_readers);
+        }
+        else
+        {
+            Report(entry.writers, type_name, matches.matched_writers);
+            Report(entry.readers, type_name, matches.matched_readers);
+        }
+    }
+
+    return matches;
+}
+
+std::vector<TopicIndex::topic_key> TopicIndex::Unmatched() const
+{
+    std::vector<topic_key> keys;
+
+    for (const Stripe& st : stripes_)
+    {
+        std::lock_guard<std::mutex> lock(st.mutex);
+        keys.insert(keys.end(), st.unmatched.begin(), st.unmatched.end());
+    }
+
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+// participant index operations
+
+ParticipantIndex::Stripe::Stripe()
+    : arena(std::make_shared<DiscoveryArena>())
+{
+    // containers keep the arena in scope when constructed, nested ones are created on insertions
+    ArenaScope scope(arena);
+    participants = spokesmen_map();
+}
+
+ParticipantIndex::Stripe& ParticipantIndex::stripe(
+        const GUID_t& ptid)
+{
+    return stripes_[GUIDHash()(ptid) % stripe_count];
+}
+
+const ParticipantIndex::Stripe& ParticipantIndex::stripe(
+        const GUID_t& ptid) const
+{
+    return stripes_[GUIDHash()(ptid) % stripe_count];
+}
+
+void ParticipantIndex::Add(
+        const GUID_t& spokesman,
+        const GUID_t& ptid)
+{
+    Stripe& st = stripe(ptid);
+    std::lock_guard<std::mutex> lock(st.mutex);
+    ArenaScope scope(st.arena);
+    st.participants[ptid].insert(spokesman);
+}
+
+void ParticipantIndex::Remove(
+        const GUID_t& spokesman,
+        const GUID_t& ptid)
+{
+    Stripe& st = stripe(ptid);
+    std::lock_guard<std::mutex> lock(st.mutex);
+
+    spokesmen_map::iterator it = st.participants.find(ptid);
+
+    if (it != st.participants.end())
+    {
+        it->second.erase(spokesman);
+
+        if (it->second.empty())
+        {
+            st.participants.erase(it);
+        }
+    }
+}
+
+void ParticipantIndex::Remove(
+        const ParticipantDiscoveryDatabase& database)
+{
+    for (const ParticipantDiscoveryItem& participant : database)
+    {
+        Remove(database.endpoint_guid, participant.endpoint_guid);
+    }
+}
+
+std::vector<GUID_t> ParticipantIndex::Find(
+        const GUID_t& ptid) const
+{
+    const Stripe& st = stripe(ptid);
+    std::lock_guard<std::mutex> lock(st.mutex);
+
+    spokesmen_map::const_iterator it = st.participants.find(ptid);
+
+    if (it == st.participants.end())
+    {
+        return std::vector<GUID_t>();
+    }
+
+    return std::vector<GUID_t>(it->second.begin(), it->second.end());
+}
+
+std::size_t ParticipantIndex::Count(
+        const GUID_t& ptid) const
+{
+    const Stripe& st = stripe(ptid);
+    std::lock_guard<std::mutex> lock(st.mutex);
+
+    spokesmen_map::const_iterator it = st.participants.find(ptid);
+
+    return it == st.participants.end() ? 0 : it->second.size();
+}
+
+// DiscoveryItemDatabase methods
+
+DiscoveryItemDatabase::Accounting::~Accounting()
+{
+    const ParticipantDiscoveryDatabase::Counters& after = database_.counters();
+
+    // unsigned wrap around yields the right totals
+    owner_.total_alive_ += after.alive - before_.alive;
+    owner_.total_zombies_ += after.zombies - before_.zombies;
+    owner_.total_writers_ += after.writers - before_.writers;
+    owner_.total_readers_ += after.readers - before_.readers;
+}
+
+DiscoveryItemDatabase::ShardAccess DiscoveryItemDatabase::LockShard(
+        const GUID_t& spokesman) const
+{
+    ShardAccess access;
+    access.map_lock = std::shared_lock<std::shared_timed_mutex>(shards_mutex);
+
+    shard_map::const_iterator it = shards.find(spokesman);
+
+    if (it != shards.end())
+    {
+        access.shard_lock = std::unique_lock<std::mutex>(it->second->shard_mutex);
+        access.shard = it->second.get();
+    }
+
+    return access;
+}
+
+DiscoveryItemDatabase::ShardAccess DiscoveryItemDatabase::AccessShard(
+        const GUID_t& spokesman,
+        const std::string& name)
+{
+    ShardAccess access = LockShard(spokesman);
+
+    // the shard may be removed between creation and locking, retry
+    while (access.shard == nullptr)
+    {
+        access = ShardAccess();
+
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(shards_mutex);
+
+            shard_map::iterator it = shards.lower_bound(spokesman);
+
+            if (it == shards.end() || it->first != spokesman)
+            {
+                // not there, emplace
+                std::shared_ptr<DiscoveryArena> arena = std::make_shared<DiscoveryArena>();
+                ArenaScope scope(arena);
+                shards.emplace_hint(it, spokesman, std::unique_ptr<Shard>(new Shard(spokesman, name, arena)));
+            }
+        }
+
+        access = LockShard(spokesman);
+    }
+
+    return access;
+}
+
+std::vector<std::unique_lock<std::mutex>> DiscoveryItemDatabase::LockAllShards() const
+{
+    std::vector<std::unique_lock<std::mutex>> locks;
+    locks.reserve(shards.size());
+
+    // shard map is ordered thus all readers lock in the same order
+    for (const shard_map::value_type& shard : shards)
+    {
+        locks.emplace_back(shard.second->shard_mutex);
+    }
+
+    return locks;
+}
+
+std::vector<ParticipantDiscoveryDatabase> DiscoveryItemDatabase::GetVersions(
+        uint64_t* sequence) const
+{
+    std::vector<ParticipantDiscoveryDatabase> versions;
+
+    std::shared_lock<std::shared_timed_mutex> map_lock(shards_mutex);
+    std::vector<std::unique_lock<std::mutex>> locks = LockAllShards();
+
+    if (sequence != nullptr)
+    {
+        // changes are recorded with their shard locked, none can be in flight
+        *sequence = journal.LastSequence();
+    }
+
+    versions.reserve(shards.size());
+
+    for (const shard_map::value_type& shard : shards)
+    {
+        versions.push_back(shard.second->publish());
+    }
+
+    return versions;
+}
+
+Snapshot DiscoveryItemDatabase::GetState() const
+{
+    uint64_t sequence;
+    return GetState(sequence);
+}
+
+Snapshot DiscoveryItemDatabase::GetState(
+        uint64_t& sequence) const
+{
+    // the snapshot shares the info of each version, only later modifications are copied
+    ArenaScope scope(std::make_shared<DiscoveryArena>());
+    Snapshot shot(creation_time_, creation_time_);
+
+    for (ParticipantDiscoveryDatabase& version : GetVersions(&sequence))
+    {
+        shot.emplace_hint(shot.end(), std::move(version));
     }
-    while ( wrap_it_ != ref_cont_.end() && !wrap_it_->is_alive );
 
-    return *this;
+    return shot;
 }
 
-ParticipantDiscoveryDatabase::smart_iterator ParticipantDiscoveryDatabase::smart_iterator::operator ++(
-        int)
+void DiscoveryItemDatabase::Journal(
+        JournalEntry::Kind kind,
+        const GUID_t& spokesman,
+        const GUID_t& ptid,
+        const GUID_t& endpoint,
+        const InternedString& type_name,
+        const InternedString& topic_name)
 {
-    smart_iterator tmp(*this);
+    JournalEntry entry;
+    entry.kind = kind;
+    entry.spokesman = spokesman;
+    entry.participant = ptid;
+    entry.endpoint = endpoint;
+    entry.type_name = type_name;
+    entry.topic_name = topic_name;
+    journal.Record(std::move(entry));
+}
 
-    operator ++();
+bool DiscoveryItemDatabase::ChangesSince(
+        uint64_t since,
+        std::vector<JournalEntry>& changes) const
+{
+    return journal.Since(since, changes);
+}
 
-    return tmp;
+uint64_t DiscoveryItemDatabase::LastSequence() const
+{
+    return journal.LastSequence();
 }
 
-ParticipantDiscoveryDatabase::smart_iterator::reference ParticipantDiscoveryDatabase::smart_iterator::operator *() const
+ObserverId DiscoveryItemDatabase::Subscribe(
+        ObserverFilter filter,
+        ObserverCallback callback,
+        ObserverExecutor executor,
+        uint64_t since)
 {
-    return (reference) * wrap_it_;
+    return notifier.Subscribe(std::move(filter), std::move(callback), std::move(executor), since);
 }
 
-ParticipantDiscoveryDatabase::smart_iterator::pointer ParticipantDiscoveryDatabase::smart_iterator::operator ->() const
+void DiscoveryItemDatabase::Unsubscribe(
+        ObserverId id)
 {
-    return &(**this);
+    notifier.Unsubscribe(id);
 }
 
-bool ParticipantDiscoveryDatabase::smart_iterator::operator ==(
-        const smart_iterator& it) const
+void DiscoveryItemDatabase::DispatchChanges()
 {
-    // note that zombies are skipped, that simplifies comparison
-    return wrap_it_ == it.wrap_it_;
+    notifier.Dispatch();
 }
 
-bool ParticipantDiscoveryDatabase::smart_iterator::operator !=(
-        const smart_iterator& it) const
+TopicMatches DiscoveryItemDatabase::QueryTopic(
+        const std::string& topic) const
 {
-    // note that zombies are skipped, that simplifies comparison
-    return !(*this == it);
+    // queries must not grow the symbol table, a name never interned was never reported
+    InternedString symbol;
+    if (!InternedString::Find(topic, symbol))
+    {
+        return TopicMatches();
+    }
+
+    return topics.Query(symbol);
 }
 
-ParticipantDiscoveryDatabase::smart_iterator ParticipantDiscoveryDatabase::smart_iterator::end() const
+std::vector<TopicIndex::topic_key> DiscoveryItemDatabase::UnmatchedTopics() const
 {
-    // the end iterator matches the wrapped iterator one
-    smart_iterator tmp(ref_cont_);
-    tmp.wrap_it_ = ref_cont_.end();
-    return tmp;
+    return topics.Unmatched();
 }
 
-// acceptable snapshot misalignment in ms
-std::chrono::milliseconds Snapshot::acceptable_offset_ = std::chrono::milliseconds(400);
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::ReapZombies(
+        const std::chrono::steady_clock::duration& grace,
+        const std::chrono::steady_clock::time_point& now)
+{
+    std::shared_lock<std::shared_timed_mutex> map_lock(shards_mutex);
+    size_type reaped = 0;
 
-// Time conversion auxiliary
-std::chrono::system_clock::time_point Snapshot::_system_clock(std::chrono::system_clock::now());
-std::chrono::steady_clock::time_point Snapshot::_steady_clock(std::chrono::steady_clock::now());
+    auto expired = [&](const ParticipantDiscoveryItem& p)
+            {
+                return !p.is_alive && now - p.zombie_since_ >= grace;
+            };
 
-std::chrono::system_clock::time_point Snapshot::getSystemTime(
-        std::chrono::steady_clock::time_point tp)
-{
-    using namespace std::chrono;
+    for (shard_map::value_type& s : shards)
+    {
+        const GUID_t& spokesman = s.first;
+        Shard& shard = *s.second;
+        std::lock_guard<std::mutex> lock(shard.shard_mutex);
 
-    return _system_clock + duration_cast<system_clock::duration>(tp - _steady_clock);
+        // only detach the shards with something to reap
+        if (shard.database.counters().zombies == 0
+                || std::none_of(shard.database.begin(), shard.database.end(), expired))
+        {
+            continue;
+        }
+
+        ArenaScope scope(shard.arena);
+        ParticipantDiscoveryDatabase& database = shard.writable();
+        Accounting accounting(*this, database);
+        ParticipantDiscoveryDatabase::iterator it = database.begin();
+
+        while (it != database.end())
+        {
+            if (!expired(*it))
+            {
+                ++it;
+                continue;
+            }
+
+            const GUID_t& ptid = it->endpoint_guid;
+
+            for (const DataWriterDiscoveryItem& writer : it->getDataWriters())
+            {
+                topics.Remove(spokesman, writer);
+                shard.writers.erase(writer.endpoint_guid);
+                Journal(JournalEntry::Kind::REMOVE_DATAWRITER, spokesman, ptid, writer.endpoint_guid,
+                        writer.type_name, writer.topic_name);
+            }
+
+            for (const DataReaderDiscoveryItem& reader : it->getDataReaders())
+            {
+                topics.Remove(spokesman, reader);
+                shard.readers.erase(reader.endpoint_guid);
+                Journal(JournalEntry::Kind::REMOVE_DATAREADER, spokesman, ptid, reader.endpoint_guid,
+                        reader.type_name, reader.topic_name);
+            }
+
+            participants.Remove(spokesman, ptid);
+            Journal(JournalEntry::Kind::REMOVE_PARTICIPANT, spokesman, ptid);
+            it = database.erase(it);
+            ++reaped;
+        }
+    }
+
+    total_reaped_ += reaped;
+    return reaped;
 }
 
-std::string Snapshot::getTimeStamp(
-        std::chrono::steady_clock::time_point snap_time)
+ZombieStatistics DiscoveryItemDatabase::GetZombieStatistics(
+        const std::chrono::steady_clock::time_point& now) const
 {
-    std::chrono::system_clock::time_point tp = Snapshot::getSystemTime(snap_time);
-    std::time_t time = std::chrono::system_clock::to_time_t(tp);
-    std::chrono::milliseconds ms =
-            std::chrono::duration_cast<std::chrono::milliseconds>(tp - std::chrono::system_clock::from_time_t(time));
+    ZombieStatistics stats;
 
-    std::ostringstream stream;
-    stream << std::put_time(localtime(&time), "%F %T.") << std::setw(3) << std::setfill('0') << ms.count() << " ";
+    // each shard is walked under its own lock, publishing a version would make its next write copy it
+    std::shared_lock<std::shared_timed_mutex> map_lock(shards_mutex);
 
-    return stream.str();
-}
+    for (const shard_map::value_type& s : shards)
+    {
+        std::lock_guard<std::mutex> shard_lock(s.second->shard_mutex);
+        const ParticipantDiscoveryDatabase& database = s.second->database;
 
-// DiscoveryItemDatabase methods
+        if (database.CountZombies() == 0)
+        {
+            continue;
+        }
+
+        for (const ParticipantDiscoveryItem& p : database)
+        {
+            if (p.is_alive)
+            {
+                continue;
+            }
+
+            // bucket by the number of decimal digits of the age in seconds
+            auto age = std::chrono::duration_cast<std::chrono::seconds>(now - p.zombie_since_).count();
+            std::size_t bucket = 0;
+
+            for (; age > 0 && bucket < ZombieStatistics::age_buckets - 1; age /= 10)
+            {
+                ++bucket;
+            }
+
+            ++stats.ages[bucket];
+            ++stats.zombies;
+        }
+    }
+
+    stats.reaped = total_reaped_;
+    return stats;
+}
 
 // Lifetime of the return objects is not guaranteed, do not store
 std::vector<const ParticipantDiscoveryItem*> DiscoveryItemDatabase::FindParticipant(
         const GUID_t& ptid) const
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
-
     std::vector<const ParticipantDiscoveryItem*> v;
 
-    // traverse the map of participants searching for one particular specific info
-    for (Snapshot::const_iterator pit = image.cbegin(); pit != image.cend(); ++pit)
+    // only visit the spokesmen that know the participant
+    for (const GUID_t& spokesman : participants.Find(ptid))
     {
-        const ParticipantDiscoveryDatabase& _database = *pit;
-        auto it = std::lower_bound(_database.cbegin(), _database.cend(), ptid);
+        ShardAccess access = LockShard(spokesman);
+
+        if (access.shard == nullptr)
+        {
+            continue; // removed meanwhile
+        }
+
+        const ParticipantDiscoveryDatabase& _database = access.shard->database;
+        auto it = _database.find(ptid);
 
-        if (it != _database.end() && *it == ptid)
+        if (it != _database.end())
         {
             v.push_back(&*it);
         }
@@ -380,33 +1108,53 @@ std::vector<const ParticipantDiscoveryItem*> DiscoveryItemDatabase::FindParticip
     return v;
 }
 
+std::vector<GUID_t> DiscoveryItemDatabase::FindSpokesmen(
+        const GUID_t& ptid) const
+{
+    return participants.Find(ptid);
+}
+
+std::size_t DiscoveryItemDatabase::CountSpokesmen(
+        const GUID_t& ptid) const
+{
+    return participants.Count(ptid);
+}
+
 bool DiscoveryItemDatabase::AddParticipant(
         const GUID_t& spokesman,
         const std::string& srcName,
         const GUID_t& ptid,
-        const std::string& name,
+        std::string name,
         const std::chrono::steady_clock::time_point& discovered_timestamp,
         bool server /* = false*/)
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = AccessShard(spokesman, srcName);
 
-    ParticipantDiscoveryDatabase& _database = image.access_snapshot(spokesman, srcName);
-    ParticipantDiscoveryDatabase::iterator it = std::lower_bound(_database.begin(), _database.end(), ptid);
+    ArenaScope scope(access.shard->arena);
+    ParticipantDiscoveryDatabase& _database = access.shard->writable();
+    Accounting accounting(*this, _database);
+    ParticipantDiscoveryDatabase::iterator it = _database.lower_bound(ptid);
 
     if (it == _database.end() || *it != ptid)
     {
-        // add participant
-        it = _database.emplace_hint(it, ptid, name, server);
+        // add participant, new items are alive thus the name is not used below
+        it = _database.emplace_hint(it, GUID_t(ptid), std::move(name), server);
+        participants.Add(spokesman, ptid);
+        Journal(JournalEntry::Kind::ADD_PARTICIPANT, spokesman, ptid);
     }
 
     // already there, assert liveliness
     if (!it->is_alive)
     {
         // update the zombie
-        it->setName(name);
-        it->acknowledge(true);
-        it->setServer(server);
-        it->setDiscoveredTimestamp(discovered_timestamp);
+        _database.modify(it, [&](const ParticipantDiscoveryItem& p)
+                {
+                    p.setName(name);
+                    p.acknowledge(true);
+                    p.setServer(server);
+                    p.setDiscoveredTimestamp(discovered_timestamp);
+                });
+        Journal(JournalEntry::Kind::ADD_PARTICIPANT, spokesman, ptid);
     }
 
     assert(it->is_server == server);
@@ -418,72 +1166,157 @@ bool DiscoveryItemDatabase::AddParticipant(
 bool DiscoveryItemDatabase::RemoveParticipant(
         const GUID_t& deceased)
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    // nobody else can access the shards meanwhile
+    std::lock_guard<std::shared_timed_mutex> lock(shards_mutex);
+
+    shard_map::iterator it = shards.find(deceased);
+
+    if (it == shards.end())
+    {
+        return false;
+    }
 
-    return image.erase(deceased) != 0;
+    const ParticipantDiscoveryDatabase::Counters& counters = it->second->database.counters();
+    total_alive_ -= counters.alive;
+    total_zombies_ -= counters.zombies;
+    total_writers_ -= counters.writers;
+    total_readers_ -= counters.readers;
+
+    topics.Remove(it->second->database);
+    participants.Remove(it->second->database);
+    shards.erase(it);
+    Journal(JournalEntry::Kind::REMOVE_SPOKESMAN, deceased, deceased);
+
+    return true;
 }
 
 bool DiscoveryItemDatabase::RemoveParticipant(
         const GUID_t& spokesman,
         const GUID_t& ptid)
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = LockShard(spokesman);
 
-    ParticipantDiscoveryDatabase& _database = image[spokesman];
-    ParticipantDiscoveryDatabase::iterator it = std::lower_bound(_database.begin(), _database.end(), ptid);
+    if (access.shard == nullptr)
+    {
+        return false; // spokesman is no there
+    }
 
-    if (it == _database.end() || *it != ptid)
+    // look up before detaching, a published version must not be copied for nothing
+    if (access.shard->database.find(ptid) == access.shard->database.end())
     {
         return false; // is no there
     }
 
+    ArenaScope scope(access.shard->arena);
+    ParticipantDiscoveryDatabase& _database = access.shard->writable();
+    Accounting accounting(*this, _database);
+    ParticipantDiscoveryDatabase::iterator it = _database.find(ptid);
+
     // If it isn't empty, mark as dead, otherwise remove
     if (it->CountEndpoints() > 0)
     {
+        if (it->is_alive)
+        {
+            Journal(JournalEntry::Kind::ZOMBIE_PARTICIPANT, spokesman, ptid);
+        }
+
         // participant death acknowledge but not their owned endpoints
-        it->acknowledge(false);
+        _database.modify(it, [](const ParticipantDiscoveryItem& p)
+                {
+                    p.acknowledge(false);
+                });
     }
     else
     {
         // participant is done
+        participants.Remove(spokesman, ptid);
         _database.erase(it);
+        Journal(JournalEntry::Kind::REMOVE_PARTICIPANT, spokesman, ptid);
     }
 
     return true;
 }
 
+namespace {
+
+//! journal entry kinds of each endpoint container
+template<class T>
+struct JournalKinds;
+
+template<>
+struct JournalKinds<ParticipantDiscoveryItem::publisher_set>
+{
+    static const JournalEntry::Kind added = JournalEntry::Kind::ADD_DATAWRITER;
+    static const JournalEntry::Kind removed = JournalEntry::Kind::REMOVE_DATAWRITER;
+};
+
+template<>
+struct JournalKinds<ParticipantDiscoveryItem::subscriber_set>
+{
+    static const JournalEntry::Kind added = JournalEntry::Kind::ADD_DATAREADER;
+    static const JournalEntry::Kind removed = JournalEntry::Kind::REMOVE_DATAREADER;
+};
+
+} // namespace
+
 template<class T>
 bool DiscoveryItemDatabase::AddEndPoint(
-        T& (ParticipantDiscoveryItem::* m)() const,
+        T& (ParticipantDiscoveryItem::* m)(uint64_t) const,
+        handle_map<T> Shard::* h,
         const GUID_t& spokesman,
         const std::string& srcName,
         const GUID_t& ptid,
         const GUID_t& id,
-        const std::string& _typename,
-        const std::string& topicname,
+        const InternedString& _typename,
+        const InternedString& topicname,
         const std::chrono::steady_clock::time_point& discovered_timestamp)
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = AccessShard(spokesman, srcName);
 
-    ParticipantDiscoveryDatabase& _database = image.access_snapshot(spokesman, srcName);
-    ParticipantDiscoveryDatabase::iterator it = std::lower_bound(_database.begin(), _database.end(), ptid);
+    ArenaScope scope(access.shard->arena);
+    ParticipantDiscoveryDatabase& _database = access.shard->writable();
+    Accounting accounting(*this, _database);
+    ParticipantDiscoveryDatabase::iterator it = _database.lower_bound(ptid);
 
-    if (it == _database.end() || ptid == spokesman )
+    if (it == _database.end() || *it != ptid)
     {
         // participant is no there, add a zombie participant
         it = _database.emplace_hint(it, ptid);
+        participants.Add(spokesman, ptid);
 
         // participant death acknowledge but not their owned endpoints
-        it->acknowledge(ptid == spokesman);
+        _database.modify(it, [&](const ParticipantDiscoveryItem& p)
+                {
+                    p.acknowledge(ptid == spokesman);
+                });
+        Journal(ptid == spokesman ? JournalEntry::Kind::ADD_PARTICIPANT : JournalEntry::Kind::ZOMBIE_PARTICIPANT,
+                spokesman, ptid);
+    }
+    else if (ptid == spokesman && !it->is_alive)
+    {
+        // our own discovery info is always alive
+        _database.modify(it, [](const ParticipantDiscoveryItem& p)
+                {
+                    p.acknowledge(true);
+                });
+        Journal(JournalEntry::Kind::ADD_PARTICIPANT, spokesman, ptid);
     }
 
-    T& cont = (*it.*m)();
-    typename T::iterator sit = std::lower_bound(cont.begin(), cont.end(), id);
+    // the item endpoints are modified below
+    it = _database.own(it);
+    T& cont = (*it.*m)(_database.generation());
+    typename T::iterator sit = cont.lower_bound(id);
 
     if (sit == cont.end() || *sit != id )
     {
-        // add endpoint
-        sit = cont.emplace_hint(sit, id, _typename, topicname, discovered_timestamp);
+        // add endpoint, names are only interned on insertion
+        _database.modify(it, [&](const ParticipantDiscoveryItem&)
+                {
+                    sit = cont.emplace_hint(sit, id, _typename, topicname, discovered_timestamp);
+                });
+        topics.Add(spokesman, *sit);
+        (access.shard->*h).emplace(id, EndpointHandle<T>{it, sit, _database.generation()});
+        Journal(JournalKinds<T>::added, spokesman, ptid, id, _typename, topicname);
     }
 
     assert(_typename == sit->type_name);
@@ -492,44 +1325,105 @@ bool DiscoveryItemDatabase::AddEndPoint(
     return true;
 }
 
+template<class T>
+typename DiscoveryItemDatabase::handle_map<T>::iterator DiscoveryItemDatabase::ResolveEndPoint(
+        T& (ParticipantDiscoveryItem::* m)(uint64_t) const,
+        handle_map<T>& handles,
+        ParticipantDiscoveryDatabase& database,
+        const GUID_t& ptid,
+        const GUID_t& id)
+{
+    typename handle_map<T>::iterator hit = handles.find(id);
+
+    if (hit == handles.end())
+    {
+        // endpoint is not there
+        return hit;
+    }
+
+    EndpointHandle<T>& handle = hit->second;
+
+    if (handle.generation == database.generation())
+    {
+        // iterators are still valid, the endpoints were already owned by this generation
+        return *handle.participant == ptid ? hit : handles.end();
+    }
+
+    // the database was detached since the handle was taken, locate the endpoint on the new copy
+    ParticipantDiscoveryDatabase::iterator it = database.find(ptid);
+
+    if (it == database.end())
+    {
+        // participant is not there, should be a zombie
+        return handles.end();
+    }
+
+    // handles keep the owned item, it is not copied again by this generation
+    it = database.own(it);
+    T& cont = (*it.*m)(database.generation());
+    typename T::iterator sit = cont.find(id);
+
+    if (sit == cont.end())
+    {
+        return handles.end();
+    }
+
+    handle = EndpointHandle<T>{it, sit, database.generation()};
+    return hit;
+}
+
 template<class T>
 bool DiscoveryItemDatabase::RemoveEndPoint(
-        T& (ParticipantDiscoveryItem::* m)() const,
+        T& (ParticipantDiscoveryItem::* m)(uint64_t) const,
+        handle_map<T> Shard::* h,
         const GUID_t& spokesman,
         const GUID_t& ptid,
         const GUID_t& id)
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = LockShard(spokesman);
 
-    if (image.find(spokesman) == image.end())
+    if (access.shard == nullptr)
     {
         return false;
     }
 
-    ParticipantDiscoveryDatabase& database = image[spokesman];
-    ParticipantDiscoveryDatabase::iterator it = std::lower_bound(database.begin(), database.end(), ptid);
+    handle_map<T>& handles = access.shard->*h;
 
-    if (it == database.end() || *it != ptid)
+    // the handles keep all the reported endpoints, look up before detaching
+    if (handles.find(id) == handles.end())
     {
-        // participant is not there, should be a zombie
         return false;
     }
 
-    T& cont = (*it.*m)();
-    typename T::iterator sit = std::lower_bound(cont.begin(), cont.end(), id);
+    ArenaScope scope(access.shard->arena);
+    ParticipantDiscoveryDatabase& database = access.shard->writable();
+    Accounting accounting(*this, database);
+    typename handle_map<T>::iterator hit = ResolveEndPoint(m, handles, database, ptid, id);
 
-    if (sit == cont.end() || *sit != id )
+    if (hit == handles.end())
     {
         // endpoint is not there
         return false;
     }
 
-    cont.erase(sit);
+    ParticipantDiscoveryDatabase::iterator it = hit->second.participant;
+    typename T::iterator sit = hit->second.endpoint;
+    handles.erase(hit);
+
+    topics.Remove(spokesman, *sit);
+    Journal(JournalKinds<T>::removed, spokesman, ptid, id, sit->type_name, sit->topic_name);
+    database.modify(it, [&](const ParticipantDiscoveryItem& p)
+            {
+                // already owned, no copy
+                (p.*m)(database.generation()).erase(sit);
+            });
 
     if (it->CountEndpoints() == 0 && !it->is_alive)
     {
         // remove participant if zombie
+        participants.Remove(spokesman, ptid);
         database.erase(it);
+        Journal(JournalEntry::Kind::REMOVE_PARTICIPANT, spokesman, ptid);
     }
     return true;
 }
@@ -539,12 +1433,12 @@ bool DiscoveryItemDatabase::AddDataReader(
         const std::string& srcName,
         const GUID_t& ptid,
         const GUID_t& sid,
-        const std::string& _typename,
-        const std::string& topicname,
+        const InternedString& _typename,
+        const InternedString& topicname,
         const std::chrono::steady_clock::time_point& discovered_timestamp)
 {
-    return AddEndPoint(&ParticipantDiscoveryItem::getDataReaders, spokesman, srcName, ptid, sid, _typename, topicname,
-                   discovered_timestamp);
+    return AddEndPoint(&ParticipantDiscoveryItem::getDataReaders, &Shard::readers, spokesman, srcName, ptid, sid,
+                   _typename, topicname, discovered_timestamp);
 }
 
 bool DiscoveryItemDatabase::RemoveDataReader(
@@ -552,7 +1446,7 @@ bool DiscoveryItemDatabase::RemoveDataReader(
         const GUID_t& ptid,
         const GUID_t& sid)
 {
-    return RemoveEndPoint(&ParticipantDiscoveryItem::getDataReaders, spokesman, ptid, sid);
+    return RemoveEndPoint(&ParticipantDiscoveryItem::getDataReaders, &Shard::readers, spokesman, ptid, sid);
 }
 
 bool DiscoveryItemDatabase::AddDataWriter(
@@ -560,12 +1454,12 @@ bool DiscoveryItemDatabase::AddDataWriter(
         const std::string& srcName,
         const GUID_t& ptid,
         const GUID_t& pid,
-        const std::string& _typename,
-        const std::string& topicname,
+        const InternedString& _typename,
+        const InternedString& topicname,
         const std::chrono::steady_clock::time_point& discovered_timestamp)
 {
-    return AddEndPoint(&ParticipantDiscoveryItem::getDataWriters, spokesman, srcName, ptid, pid, _typename, topicname,
-                   discovered_timestamp);
+    return AddEndPoint(&ParticipantDiscoveryItem::getDataWriters, &Shard::writers, spokesman, srcName, ptid, pid,
+                   _typename, topicname, discovered_timestamp);
 }
 
 bool DiscoveryItemDatabase::RemoveDataWriter(
@@ -573,7 +1467,7 @@ bool DiscoveryItemDatabase::RemoveDataWriter(
         const GUID_t& ptid,
         const GUID_t& pid)
 {
-    return RemoveEndPoint(&ParticipantDiscoveryItem::getDataWriters, spokesman, ptid, pid);
+    return RemoveEndPoint(&ParticipantDiscoveryItem::getDataWriters, &Shard::writers, spokesman, ptid, pid);
 }
 
 void DiscoveryItemDatabase::UpdateSubLiveliness(
@@ -581,128 +1475,137 @@ void DiscoveryItemDatabase::UpdateSubLiveliness(
         int32_t alive_count,
         int32_t not_alive_count)
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
-
     // Retrieve the participant that owns this subscriber
     GUID_t pguid(subs);
     pguid.entityId = eprosima::fastdds::rtps::c_EntityId_RTPSParticipant;
 
-    if (image.find(pguid) == image.end())
+    ShardAccess access = LockShard(pguid);
+
+    if (access.shard == nullptr)
     {
         return;
     }
-    // Locate the PtDI associated with the subscriber
-    ParticipantDiscoveryDatabase& database = image[pguid];
-    ParticipantDiscoveryDatabase::iterator it = std::lower_bound(database.begin(), database.end(), pguid);
+    // Locate the SDI associated with the subscriber through its handle, detaching only if it is there
+    handle_map<ParticipantDiscoveryItem::subscriber_set>& handles = access.shard->readers;
+    handle_map<ParticipantDiscoveryItem::subscriber_set>::iterator hit = handles.find(subs);
+    ParticipantDiscoveryDatabase* database = &access.shard->database;
+    ArenaScope scope(access.shard->arena);
 
-    if (it == database.end() || *it != pguid)
+    if (hit != handles.end())
     {
-        // participant should be here because the subscriber should create it on its callback
-        LOG_ERROR("Non reported subscriber liveliness callback. Participant:" << pguid);
-        return;
+        database = &access.shard->writable();
+        hit = ResolveEndPoint(&ParticipantDiscoveryItem::getDataReaders, handles, *database, pguid, subs);
     }
 
-    // Locate the SDI associated with the subscriber
-    ParticipantDiscoveryItem::subscriber_set& ss = it->getDataReaders();
-    ParticipantDiscoveryItem::subscriber_set::iterator sit = std::lower_bound(ss.begin(), ss.end(), subs);
-
-    if (sit == ss.end() || *sit != subs)
+    if (hit == handles.end())
     {
-        // subscriber should be here because should be created on its callback
-        LOG_ERROR("Non reported subscriber liveliness callback. Subscriber: " << subs);
+        if (database->find(pguid) == database->end())
+        {
+            // participant should be here because the subscriber should create it on its callback
+            LOG_ERROR("Non reported subscriber liveliness callback. Participant:" << pguid);
+        }
+        else
+        {
+            // subscriber should be here because should be created on its callback
+            LOG_ERROR("Non reported subscriber liveliness callback. Subscriber: " << subs);
+        }
         return;
     }
 
-    // Update the liveliness info
-    DataReaderDiscoveryItem& sub = const_cast<DataReaderDiscoveryItem&>(*sit);
+    // Update the liveliness info, the handle endpoints are owned by the current generation
+    DataReaderDiscoveryItem& sub = const_cast<DataReaderDiscoveryItem&>(*hit->second.endpoint);
 
     sub.alive_count = alive_count;
     sub.not_alive_count = not_alive_count;
 
+    JournalEntry entry;
+    entry.kind = JournalEntry::Kind::UPDATE_LIVELINESS;
+    entry.spokesman = pguid;
+    entry.participant = pguid;
+    entry.endpoint = subs;
+    entry.type_name = sub.type_name;
+    entry.topic_name = sub.topic_name;
+    entry.alive_count = alive_count;
+    entry.not_alive_count = not_alive_count;
+    journal.Record(std::move(entry));
+
     LOG_INFO("Subscriber " << subs << " liveliness callback reporting:"
             " alive_count " << alive_count <<
             " not_alive_count " << not_alive_count )
 }
 
-DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountParticipants(
-        const GUID_t& spokesman) const
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountParticipants() const
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    return total_alive_ + total_zombies_;
+}
 
-    const ParticipantDiscoveryDatabase* p = image[spokesman];
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountZombies() const
+{
+    return total_zombies_;
+}
 
-    if (p != nullptr)
-    {
-        return p->size();
-    }
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataReaders() const
+{
+    return total_readers_;
+}
 
-    return 0;
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataWriters() const
+{
+    return total_writers_;
 }
 
-DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataReaders(
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountParticipants(
         const GUID_t& spokesman) const
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = LockShard(spokesman);
 
-    const ParticipantDiscoveryDatabase* p = image[spokesman];
+    return access.shard ? access.shard->database.CountParticipants() : 0;
+}
 
-    if (p != nullptr)
-    {
-        size_type count = 0;
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountZombies(
+        const GUID_t& spokesman) const
+{
+    ShardAccess access = LockShard(spokesman);
 
-        for (const ParticipantDiscoveryItem& part : *p)
-        {
-            count += part.datareaders.size();
-        }
+    return access.shard ? access.shard->database.CountZombies() : 0;
+}
 
-        return count;
-    }
+DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataReaders(
+        const GUID_t& spokesman) const
+{
+    ShardAccess access = LockShard(spokesman);
 
-    return 0;
+    return access.shard ? access.shard->database.CountDataReaders() : 0;
 }
 
 DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataWriters(
         const GUID_t& spokesman) const
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
-
-    const ParticipantDiscoveryDatabase* p = image[spokesman];
-
-    if (p != nullptr)
-    {
-        size_type count = 0;
-
-        for (const ParticipantDiscoveryItem& part : *p)
-        {
-            count += part.datawriters.size();
-        }
-
-        return count;
-    }
+    ShardAccess access = LockShard(spokesman);
 
-    return 0;
+    return access.shard ? access.shard->database.CountDataWriters() : 0;
 }
 
 DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataReaders(
         const GUID_t& spokesman,
         const GUID_t& ptid) const
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = LockShard(spokesman);
 
-    const ParticipantDiscoveryDatabase* p = image[spokesman];
+    const ParticipantDiscoveryDatabase* p = access.shard ? &access.shard->database : nullptr;
 
     if (p != nullptr)
     {
         const ParticipantDiscoveryDatabase& database = *p;
-        ParticipantDiscoveryDatabase::iterator it = std::lower_bound(database.begin(), database.end(), ptid);
+        ParticipantDiscoveryDatabase::iterator it = database.find(ptid);
 
-        if (it == database.end() || *it != ptid)
+        if (it == database.end())
         {
             // participant is no there
             return 0;
         }
 
-        return it->datareaders.size();
+        return it->CountDataReaders();
     }
 
     return 0;
@@ -712,22 +1615,22 @@ DiscoveryItemDatabase::size_type DiscoveryItemDatabase::CountDataWriters(
         const GUID_t& spokesman,
         const GUID_t& ptid) const
 {
-    std::lock_guard<std::mutex> lock(database_mutex);
+    ShardAccess access = LockShard(spokesman);
 
-    const ParticipantDiscoveryDatabase* p = image[spokesman];
+    const ParticipantDiscoveryDatabase* p = access.shard ? &access.shard->database : nullptr;
 
     if (p != nullptr)
     {
         const ParticipantDiscoveryDatabase& database = *p;
-        ParticipantDiscoveryDatabase::iterator it = std::lower_bound(database.begin(), database.end(), ptid);
+        ParticipantDiscoveryDatabase::iterator it = database.find(ptid);
 
-        if (it == database.end() || *it != ptid)
+        if (it == database.end())
         {
             // participant is no there
             return 0;
         }
 
-        return it->datawriters.size();
+        return it->CountDataWriters();
     }
 
     return 0;
@@ -814,13 +1717,13 @@ ParticipantDiscoveryDatabase& Snapshot::access_snapshot (
         const GUID_t& id,
         const std::string& name)
 {
-    auto it = std::lower_bound(begin(), end(), id);
+    auto it = lower_bound(id);
     const ParticipantDiscoveryDatabase* p = nullptr;
 
     if (it == end() || *it != id)
     {
         // not there, emplace
-        p = &(*emplace(id, name).first);
+        p = &*emplace_hint(it, id, name);
     }
     else
     {
@@ -833,14 +1736,14 @@ ParticipantDiscoveryDatabase& Snapshot::access_snapshot (
 ParticipantDiscoveryDatabase& Snapshot::operator [](
         const GUID_t& id)
 {
-    auto it = std::lower_bound(begin(), end(), id);
+    auto it = lower_bound(id);
     const ParticipantDiscoveryDatabase* p = nullptr;
 
     if (it == end() || *it != id)
     {
         // not there, emplace
         // should never be called from this operator
-        p = &(*emplace(id, "").first);
+        p = &*emplace_hint(it, id, "");
     }
     else
     {
@@ -853,9 +1756,9 @@ ParticipantDiscoveryDatabase& Snapshot::operator [](
 const ParticipantDiscoveryDatabase* Snapshot::operator [](
         const GUID_t& id) const
 {
-    auto it = std::lower_bound(begin(), end(), id);
+    auto it = find(id);
 
-    if (it == end() || *it != id)
+    if (it == end())
     {
         return nullptr; // not there
     }
@@ -893,14 +1796,14 @@ void Snapshot::to_xml(
     {
         XMLElement* pPtdb = xmlDoc.NewElement(s_sPtDB.c_str());
         {
-            std::stringstream sstream;
-            sstream << discovery_database.endpoint_guid.guidPrefix;
-            pPtdb->SetAttribute(s_sGUID_prefix.c_str(), sstream.str().c_str());
+            char text[guid_codec::prefix_size];
+            guid_codec::Encode(discovery_database.endpoint_guid.guidPrefix, text);
+            pPtdb->SetAttribute(s_sGUID_prefix.c_str(), text);
         }
         {
-            std::stringstream sstream;
-            sstream << discovery_database.endpoint_guid.entityId;
-            pPtdb->SetAttribute(s_sGUID_entity.c_str(), sstream.str().c_str());
+            char text[guid_codec::entity_size];
+            guid_codec::Encode(discovery_database.endpoint_guid.entityId, text);
+            pPtdb->SetAttribute(s_sGUID_entity.c_str(), text);
         }
         {
             std::stringstream sstream;
@@ -912,14 +1815,14 @@ void Snapshot::to_xml(
         {
             XMLElement* pPtdi = xmlDoc.NewElement(s_sPtDI.c_str());
             {
-                std::stringstream sstream;
-                sstream << discovery_item.endpoint_guid.guidPrefix;
-                pPtdi->SetAttribute(s_sGUID_prefix.c_str(), sstream.str().c_str());
+                char text[guid_codec::prefix_size];
+                guid_codec::Encode(discovery_item.endpoint_guid.guidPrefix, text);
+                pPtdi->SetAttribute(s_sGUID_prefix.c_str(), text);
             }
             {
-                std::stringstream sstream;
-                sstream << discovery_item.endpoint_guid.entityId;
-                pPtdi->SetAttribute(s_sGUID_entity.c_str(), sstream.str().c_str());
+                char text[guid_codec::entity_size];
+                guid_codec::Encode(discovery_item.endpoint_guid.entityId, text);
+                pPtdi->SetAttribute(s_sGUID_entity.c_str(), text);
             }
 
             pPtdi->SetAttribute(s_sServer.c_str(), discovery_item.is_server);
@@ -929,20 +1832,20 @@ void Snapshot::to_xml(
                     std::chrono::duration_cast<std::chrono::milliseconds>(
                         discovery_item.discovered_timestamp_ - process_startup_).count());
 
-            for (const DataReaderDiscoveryItem& sub : discovery_item.datareaders)
+            for (const DataReaderDiscoveryItem& sub : discovery_item.getDataReaders())
             {
                 XMLElement* pSub = xmlDoc.NewElement(s_sSubscriber.c_str());
                 pSub->SetAttribute(s_sType.c_str(), sub.type_name.c_str());
                 pSub->SetAttribute(s_sTopic.c_str(), sub.topic_name.c_str());
                 {
-                    std::stringstream sstream;
-                    sstream << sub.endpoint_guid.guidPrefix;
-                    pSub->SetAttribute(s_sGUID_prefix.c_str(), sstream.str().c_str());
+                    char text[guid_codec::prefix_size];
+                    guid_codec::Encode(sub.endpoint_guid.guidPrefix, text);
+                    pSub->SetAttribute(s_sGUID_prefix.c_str(), text);
                 }
                 {
-                    std::stringstream sstream;
-                    sstream << sub.endpoint_guid.entityId;
-                    pSub->SetAttribute(s_sGUID_entity.c_str(), sstream.str().c_str());
+                    char text[guid_codec::entity_size];
+                    guid_codec::Encode(sub.endpoint_guid.entityId, text);
+                    pSub->SetAttribute(s_sGUID_entity.c_str(), text);
                 }
                 pSub->SetAttribute(s_sDiscovered_timestamp.c_str(),
                         std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -960,20 +1863,20 @@ void Snapshot::to_xml(
                 pPtdi->InsertEndChild(pSub);
             }
 
-            for (const DataWriterDiscoveryItem& pub : discovery_item.datawriters)
+            for (const DataWriterDiscoveryItem& pub : discovery_item.getDataWriters())
             {
                 XMLElement* pPub = xmlDoc.NewElement(s_sPublisher.c_str());
                 pPub->SetAttribute(s_sType.c_str(), pub.type_name.c_str());
                 pPub->SetAttribute(s_sTopic.c_str(), pub.topic_name.c_str());
                 {
-                    std::stringstream sstream;
-                    sstream << pub.endpoint_guid.guidPrefix;
-                    pPub->SetAttribute(s_sGUID_prefix.c_str(), sstream.str().c_str());
+                    char text[guid_codec::prefix_size];
+                    guid_codec::Encode(pub.endpoint_guid.guidPrefix, text);
+                    pPub->SetAttribute(s_sGUID_prefix.c_str(), text);
                 }
                 {
-                    std::stringstream sstream;
-                    sstream << pub.endpoint_guid.entityId;
-                    pPub->SetAttribute(s_sGUID_entity.c_str(), sstream.str().c_str());
+                    char text[guid_codec::entity_size];
+                    guid_codec::Encode(pub.endpoint_guid.entityId, text);
+                    pPub->SetAttribute(s_sGUID_entity.c_str(), text);
                 }
                 pPub->SetAttribute(s_sDiscovered_timestamp.c_str(),
                         std::chrono::duration_cast<std::chrono::milliseconds>(
@@ -992,30 +1895,15 @@ void Snapshot::from_xml(
         tinyxml2::XMLElement* pRoot)
 {
     using namespace tinyxml2;
-    using eprosima::fastdds::rtps::GuidPrefix_t;
-    using eprosima::fastdds::rtps::EntityId_t;
 
     if (pRoot != nullptr)
     {
-        {
-            // load timestamps
-            using namespace std::chrono;
-
-            milliseconds dts(pRoot->Int64Attribute(s_sTimestamp.c_str()));
-            milliseconds dpt(pRoot->Int64Attribute(s_sProcessTime.c_str()));
-            milliseconds d_pdp_cb(pRoot->Int64Attribute(s_sLastPdpCallback.c_str()));
-            milliseconds d_edp_cb(pRoot->Int64Attribute(s_sLastEdpCallback.c_str()));
-
-            // recreate the steady_clock::time_point from the timestamp
-            _time = (system_clock::time_point() + dts) - _system_clock + _steady_clock;
-
-            // update the original process startup time for this snapshot
-            process_startup_ = _time - dpt;
-
-            // recreate the steady_clock__time_point from last_callback
-            last_PDP_callback_ = process_startup_ + d_pdp_cb;
-            last_EDP_callback_ = process_startup_ + d_edp_cb;
-        }
+        // load timestamps
+        restore_times(
+            std::chrono::milliseconds(pRoot->Int64Attribute(s_sTimestamp.c_str())),
+            std::chrono::milliseconds(pRoot->Int64Attribute(s_sProcessTime.c_str())),
+            std::chrono::milliseconds(pRoot->Int64Attribute(s_sLastPdpCallback.c_str())),
+            std::chrono::milliseconds(pRoot->Int64Attribute(s_sLastEdpCallback.c_str())));
 
         if_someone = pRoot->BoolAttribute(s_sSomeone.c_str(), true);
 
@@ -1031,50 +1919,19 @@ void Snapshot::from_xml(
                 pPtdb = pPtdb->NextSiblingElement(s_sPtDB.c_str()))
         {
             GUID_t ptdb_guid;
-            {
-                GuidPrefix_t guidPrefix;
-                {
-                    std::string guid = pPtdb->Attribute(s_sGUID_prefix.c_str());
-                    std::stringstream sstream;
-                    sstream << guid;
-                    sstream >> guidPrefix;
-                }
-                EntityId_t entityId;
-                {
-                    std::string guid = pPtdb->Attribute(s_sGUID_entity.c_str());
-                    std::stringstream sstream;
-                    sstream << guid;
-                    sstream >> entityId;
-                }
-                ptdb_guid.guidPrefix = guidPrefix;
-                ptdb_guid.entityId = entityId;
-            }
+            guid_codec::Decode(pPtdb->Attribute(s_sGUID_prefix.c_str()), ptdb_guid.guidPrefix);
+            guid_codec::Decode(pPtdb->Attribute(s_sGUID_entity.c_str()), ptdb_guid.entityId);
 
-            ParticipantDiscoveryDatabase discovery_database(ptdb_guid);
+            const char* ptdb_name = pPtdb->Attribute(s_sName.c_str());
+            ParticipantDiscoveryDatabase discovery_database(ptdb_guid, ptdb_name ? ptdb_name : "");
 
             for (XMLElement* pPtdi = pPtdb->FirstChildElement(s_sPtDI.c_str());
                     pPtdi != nullptr;
                     pPtdi = pPtdi->NextSiblingElement(s_sPtDI.c_str()))
             {
                 GUID_t ptdi_guid;
-                {
-                    GuidPrefix_t guidPrefix;
-                    {
-                        std::string guid = pPtdi->Attribute(s_sGUID_prefix.c_str());
-                        std::stringstream sstream;
-                        sstream << guid;
-                        sstream >> guidPrefix;
-                    }
-                    EntityId_t entityId;
-                    {
-                        std::string guid = pPtdi->Attribute(s_sGUID_entity.c_str());
-                        std::stringstream sstream;
-                        sstream << guid;
-                        sstream >> entityId;
-                    }
-                    ptdi_guid.guidPrefix = guidPrefix;
-                    ptdi_guid.entityId = entityId;
-                }
+                guid_codec::Decode(pPtdi->Attribute(s_sGUID_prefix.c_str()), ptdi_guid.guidPrefix);
+                guid_codec::Decode(pPtdi->Attribute(s_sGUID_entity.c_str()), ptdi_guid.entityId);
 
                 ParticipantDiscoveryItem discovery_item(
                     ptdi_guid,
@@ -1090,25 +1947,8 @@ void Snapshot::from_xml(
                         pSub = pSub->NextSiblingElement(s_sSubscriber.c_str()))
                 {
                     GUID_t sub_guid;
-                    {
-                        GuidPrefix_t guidPrefix;
-                        {
-                            std::string guid = pSub->Attribute(s_sGUID_prefix.c_str());
-                            std::stringstream sstream;
-                            sstream << guid;
-                            sstream >> guidPrefix;
-                        }
-                        EntityId_t entityId;
-                        {
-                            std::string guid = pSub->Attribute(s_sGUID_entity.c_str());
-                            std::stringstream sstream;
-                            sstream << guid;
-                            sstream >> entityId;
-                        }
-                        sub_guid.guidPrefix = guidPrefix;
-                        sub_guid.entityId = entityId;
-
-                    }
+                    guid_codec::Decode(pSub->Attribute(s_sGUID_prefix.c_str()), sub_guid.guidPrefix);
+                    guid_codec::Decode(pSub->Attribute(s_sGUID_entity.c_str()), sub_guid.entityId);
 
                     std::chrono::milliseconds disc_t(pSub->Int64Attribute(s_sDiscovered_timestamp.c_str()));
                     DataReaderDiscoveryItem sub(sub_guid, pSub->Attribute(s_sType.c_str()),
@@ -1122,7 +1962,7 @@ void Snapshot::from_xml(
                         show_liveliness_ = true; // if present any attributes set liveliness
                     }
 
-                    discovery_item.datareaders.insert(std::move(sub));
+                    discovery_item.getDataReaders(discovery_database.generation()).insert(std::move(sub));
                 }
 
                 for (XMLElement* pPub = pPtdi->FirstChildElement(s_sPublisher.c_str());
@@ -1130,30 +1970,14 @@ void Snapshot::from_xml(
                         pPub = pPub->NextSiblingElement(s_sPublisher.c_str()))
                 {
                     GUID_t pub_guid;
-                    {
-                        GuidPrefix_t guidPrefix;
-                        {
-                            std::string guid = pPub->Attribute(s_sGUID_prefix.c_str());
-                            std::stringstream sstream;
-                            sstream << guid;
-                            sstream >> guidPrefix;
-                        }
-                        EntityId_t entityId;
-                        {
-                            std::string guid = pPub->Attribute(s_sGUID_entity.c_str());
-                            std::stringstream sstream;
-                            sstream << guid;
-                            sstream >> entityId;
-                        }
-                        pub_guid.guidPrefix = guidPrefix;
-                        pub_guid.entityId = entityId;
-                    }
+                    guid_codec::Decode(pPub->Attribute(s_sGUID_prefix.c_str()), pub_guid.guidPrefix);
+                    guid_codec::Decode(pPub->Attribute(s_sGUID_entity.c_str()), pub_guid.entityId);
 
                     std::chrono::milliseconds disc_t(pPub->Int64Attribute(s_sDiscovered_timestamp.c_str()));
                     DataWriterDiscoveryItem pub(pub_guid, pPub->Attribute(s_sType.c_str()),
                             pPub->Attribute(s_sTopic.c_str()),
                             process_startup_ + disc_t);
-                    discovery_item.datawriters.insert(std::move(pub));
+                    discovery_item.getDataWriters(discovery_database.generation()).insert(std::move(pub));
                 }
 
                 discovery_database.insert(std::move(discovery_item));
@@ -1165,6 +1989,25 @@ void Snapshot::from_xml(
     }
 }
 
+void Snapshot::restore_times(
+        std::chrono::milliseconds timestamp,
+        std::chrono::milliseconds process_time,
+        std::chrono::milliseconds last_pdp_callback,
+        std::chrono::milliseconds last_edp_callback)
+{
+    using namespace std::chrono;
+
+    // recreate the steady_clock::time_point from the timestamp
+    _time = (system_clock::time_point() + timestamp) - _system_clock + _steady_clock;
+
+    // update the original process startup time for this snapshot
+    process_startup_ = _time - process_time;
+
+    // recreate the steady_clock__time_point from last_callback
+    last_PDP_callback_ = process_startup_ + last_pdp_callback;
+    last_EDP_callback_ = process_startup_ + last_edp_callback;
+}
+
 Snapshot& Snapshot::operator +=(
         const Snapshot& sh)
 {
@@ -1230,3 +2073,19 @@ std::ostream& eprosima::discovery_server::operator <<(
 
     return os;
 }
+
+std::ostream& eprosima::discovery_server::operator <<(
+        std::ostream& os,
+        const ZombieStatistics& stats)
+{
+    static const char* labels[ZombieStatistics::age_buckets] = {"<1s", "<10s", "<100s", "<1000s", "<10000s", ">=10000s"};
+
+    os << stats.zombies << " zombies, " << stats.reaped << " reaped, ages";
+
+    for (std::size_t i = 0; i < ZombieStatistics::age_buckets; ++i)
+    {
+        os << " " << labels[i] << ":" << stats.ages[i];
+    }
+
+    return os;
+}
@@ -0,0 +1,209 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "DiscoveryJournal.h"
+
+using namespace eprosima::discovery_server;
+
+DiscoveryJournal::DiscoveryJournal(
+        std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1))
+    , chunks_(new std::atomic<Chunk*>[(capacity_ + chunk_size - 1) / chunk_size])
+{
+    for (std::size_t i = 0; i < (capacity_ + chunk_size - 1) / chunk_size; ++i)
+    {
+        chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+DiscoveryJournal::~DiscoveryJournal()
+{
+    for (std::size_t i = 0; i < (capacity_ + chunk_size - 1) / chunk_size; ++i)
+    {
+        delete chunks_[i].load(std::memory_order_relaxed);
+    }
+}
+
+DiscoveryJournal::Slot* DiscoveryJournal::slot(
+        uint64_t sequence,
+        bool create) const
+{
+    std::size_t index = static_cast<std::size_t>((sequence - 1) % capacity_);
+    std::atomic<Chunk*>& chunk = chunks_[index >> chunk_bits];
+    Chunk* c = chunk.load(std::memory_order_acquire);
+
+    if (c == nullptr && create)
+    {
+        // racing writers allocate at most one chunk each, the losers release theirs
+        Chunk* fresh = new Chunk;
+
+        if (chunk.compare_exchange_strong(c, fresh, std::memory_order_acq_rel))
+        {
+            c = fresh;
+        }
+        else
+        {
+            delete fresh;
+        }
+    }
+
+    return c == nullptr ? nullptr : &c->slots[index & (chunk_size - 1)];
+}
+
+uint64_t DiscoveryJournal::Record(
+        JournalEntry&& entry)
+{
+    entry.timestamp = std::chrono::steady_clock::now();
+
+    // callers record with their shard locked, so each shard changes keep their order
+    uint64_t sequence = last_sequence_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    entry.sequence = sequence;
+
+    Slot& s = *slot(sequence, true);
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    // a writer a whole lap ahead may have filled the slot already
+    if (s.entry.sequence < sequence)
+    {
+        s.entry = std::move(entry);
+    }
+
+    return sequence;
+}
+
+bool DiscoveryJournal::Since(
+        uint64_t since,
+        std::vector<JournalEntry>& changes) const
+{
+    uint64_t last = last_sequence_.load(std::memory_order_acquire);
+
+    if (since >= last)
+    {
+        return true; // up to date
+    }
+
+    if (last - since > capacity_)
+    {
+        return false; // the consumer missed discarded entries
+    }
+
+    // sequences are consecutive, each entry position is known
+    std::size_t size = changes.size();
+    changes.reserve(size + (last - since));
+
+    for (uint64_t sequence = since + 1; sequence <= last; ++sequence)
+    {
+        const Slot* s = slot(sequence, false);
+
+        if (s == nullptr)
+        {
+            break; // claimed but not filled yet
+        }
+
+        std::lock_guard<std::mutex> lock(s->mutex);
+
+        if (s->entry.sequence < sequence)
+        {
+            break; // claimed but not filled yet
+        }
+
+        if (s->entry.sequence > sequence)
+        {
+            changes.resize(size);
+            return false; // overwritten meanwhile
+        }
+
+        changes.push_back(s->entry);
+    }
+
+    return true;
+}
+
+uint64_t DiscoveryJournal::LastSequence() const
+{
+    return last_sequence_.load(std::memory_order_acquire);
+}
+
+uint64_t DiscoveryJournal::FirstSequence() const
+{
+    uint64_t last = last_sequence_.load(std::memory_order_acquire);
+    return last + 1 - std::min<uint64_t>(last, capacity_);
+}
+
+std::ostream& eprosima::discovery_server::operator <<(
+        std::ostream& o,
+        JournalEntry::Kind kind)
+{
+    typedef JournalEntry::Kind K;
+
+    switch (kind)
+    {
+        case K::ADD_PARTICIPANT:
+            return o << "ADD_PARTICIPANT";
+        case K::ZOMBIE_PARTICIPANT:
+            return o << "ZOMBIE_PARTICIPANT";
+        case K::REMOVE_PARTICIPANT:
+            return o << "REMOVE_PARTICIPANT";
+        case K::ADD_DATAREADER:
+            return o << "ADD_DATAREADER";
+        case K::REMOVE_DATAREADER:
+            return o << "REMOVE_DATAREADER";
+        case K::ADD_DATAWRITER:
+            return o << "ADD_DATAWRITER";
+        case K::REMOVE_DATAWRITER:
+            return o << "REMOVE_DATAWRITER";
+        case K::UPDATE_LIVELINESS:
+            return o << "UPDATE_LIVELINESS";
+        case K::REMOVE_SPOKESMAN:
+            return o << "REMOVE_SPOKESMAN";
+        default: // unknown value, error
+            o.setstate(std::ios::failbit);
+    }
+
+    return o;
+}
+
+std::ostream& eprosima::discovery_server::operator <<(
+        std::ostream& o,
+        const JournalEntry& entry)
+{
+    o << "#" << entry.sequence << " " << entry.kind << " spokesman " << entry.spokesman;
+
+    if (entry.kind != JournalEntry::Kind::REMOVE_SPOKESMAN)
+    {
+        o << " participant " << entry.participant;
+    }
+
+    switch (entry.kind)
+    {
+        case JournalEntry::Kind::ADD_DATAREADER:
+        case JournalEntry::Kind::ADD_DATAWRITER:
+            o << " endpoint " << entry.endpoint << " type " << entry.type_name << " topic " << entry.topic_name;
+            break;
+        case JournalEntry::Kind::REMOVE_DATAREADER:
+        case JournalEntry::Kind::REMOVE_DATAWRITER:
+            o << " endpoint " << entry.endpoint << " topic " << entry.topic_name;
+            break;
+        case JournalEntry::Kind::UPDATE_LIVELINESS:
+            o << " endpoint " << entry.endpoint << " topic " << entry.topic_name << " alive " << entry.alive_count
+              << " not alive " << entry.not_alive_count;
+            break;
+        default:
+            break;
+    }
+
+    return o;
+}
@@ -0,0 +1,224 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "DiscoveryNotifier.h"
+
+using namespace eprosima::discovery_server;
+
+namespace {
+
+template<class T>
+bool selected(
+        const std::vector<T>& criteria,
+        const T& value)
+{
+    return criteria.empty() || std::find(criteria.begin(), criteria.end(), value) != criteria.end();
+}
+
+} // namespace
+
+bool ObserverFilter::matches(
+        const JournalEntry& entry) const
+{
+    if (!selected(spokesmen, entry.spokesman))
+    {
+        return false;
+    }
+
+    if (entry.kind == JournalEntry::Kind::REMOVE_SPOKESMAN)
+    {
+        // everything the spokesman reported is gone
+        return true;
+    }
+
+    return selected(participants, entry.participant) && selected(topics, entry.topic_name);
+}
+
+DiscoveryNotifier::DiscoveryNotifier(
+        const DiscoveryJournal& journal,
+        std::chrono::milliseconds period)
+    : journal_(journal)
+    , period_(period)
+{
+}
+
+DiscoveryNotifier::~DiscoveryNotifier()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+
+    wakeup_.notify_one();
+
+    if (notifier_.joinable())
+    {
+        notifier_.join();
+    }
+}
+
+ObserverId DiscoveryNotifier::Subscribe(
+        ObserverFilter filter,
+        ObserverCallback callback,
+        ObserverExecutor executor,
+        uint64_t since)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Observer observer;
+    observer.id = ++next_id_;
+    observer.filter = std::move(filter);
+    observer.callback = std::make_shared<ObserverCallback>(std::move(callback));
+    observer.executor = std::move(executor);
+    observer.delivered = std::min(since, journal_.LastSequence());
+    observers_.push_back(std::move(observer));
+
+    // no thread till somebody observes
+    if (!notifier_.joinable())
+    {
+        notifier_ = std::thread(&DiscoveryNotifier::run, this);
+    }
+
+    return next_id_;
+}
+
+void DiscoveryNotifier::Unsubscribe(
+        ObserverId id)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        observers_.erase(std::remove_if(observers_.begin(), observers_.end(), [id](const Observer& o)
+                {
+                    return o.id == id;
+                }), observers_.end());
+    }
+
+    if (dispatcher_.load() != std::this_thread::get_id())
+    {
+        // wait for any ongoing hand over
+        std::lock_guard<std::mutex> lock(dispatch_mutex_);
+    }
+}
+
+void DiscoveryNotifier::Dispatch()
+{
+    std::lock_guard<std::mutex> dispatch_lock(dispatch_mutex_);
+
+    // callbacks run inline may unsubscribe
+    dispatcher_ = std::this_thread::get_id();
+    dispatch();
+    dispatcher_ = std::thread::id();
+}
+
+void DiscoveryNotifier::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (!wakeup_.wait_for(lock, period_, [this]()
+            {
+                return stop_;
+            }))
+    {
+        lock.unlock();
+        Dispatch();
+        lock.lock();
+    }
+}
+
+void DiscoveryNotifier::dispatch()
+{
+    // work on a copy, callbacks run inline may subscribe or unsubscribe
+    std::vector<Observer> observers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        observers = observers_;
+    }
+
+    if (observers.empty())
+    {
+        return;
+    }
+
+    uint64_t since = std::min_element(observers.begin(), observers.end(), [](
+                        const Observer& a,
+                        const Observer& b)
+                    {
+                        return a.delivered < b.delivered;
+                    })->delivered;
+
+    std::vector<JournalEntry> changes;
+
+    // the journal may discard entries meanwhile
+    while (!journal_.Since(since, changes))
+    {
+        since = journal_.FirstSequence() - 1;
+    }
+
+    if (changes.empty())
+    {
+        return;
+    }
+
+    uint64_t first = changes.front().sequence;
+    uint64_t last = changes.back().sequence;
+    ObserverId served = observers.back().id; // ids grow with each subscription
+
+    for (Observer& observer : observers)
+    {
+        DiscoveryChanges batch;
+        batch.lost = observer.delivered + 1 < first;
+
+        for (const JournalEntry& entry : changes)
+        {
+            if (entry.sequence > observer.delivered && observer.filter.matches(entry))
+            {
+                batch.entries.push_back(entry);
+            }
+        }
+
+        if (batch.entries.empty() && !batch.lost)
+        {
+            continue;
+        }
+
+        if (observer.executor)
+        {
+            std::shared_ptr<ObserverCallback> callback = observer.callback;
+            std::shared_ptr<DiscoveryChanges> shared_batch = std::make_shared<DiscoveryChanges>(std::move(batch));
+
+            observer.executor([callback, shared_batch]()
+                    {
+                        (*callback)(*shared_batch);
+                    });
+        }
+        else
+        {
+            (*observer.callback)(batch);
+        }
+    }
+
+    // advance the observers served that are still subscribed
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (Observer& observer : observers_)
+    {
+        if (observer.id <= served)
+        {
+            observer.delivered = std::max(observer.delivered, last);
+        }
+    }
+}
@@ -12,9 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <stdexcept>
 
 #include <tinyxml2.h>
 
@@ -27,8 +29,11 @@
 #include <fastdds/rtps/writer/WriterDiscoveryStatus.hpp>
 
 #include "DiscoveryServerManager.h"
+#include "GuidCodec.h"
 #include "IDs.h"
 #include "LateJoiner.h"
+#include "SnapshotBinary.h"
+#include "SnapshotXmlWriter.h"
 #include "log/DSLog.h"
 
 using namespace eprosima::fastdds;
@@ -53,6 +58,35 @@ const char* TOPIC = "topic";
 } // namespace fastdds
 } // namespace eprosima
 
+namespace {
+
+//! interns a builtin topic data string straight from its buffer
+template<class FixedString>
+InternedString intern(
+        const FixedString& s)
+{
+    return InternedString(s.c_str(), s.size());
+}
+
+//! removes the endpoints of a participant, GUID_t order keeps them contiguous after the prefix lower bound
+template<class EndpointMap>
+void erase_prefix(
+        EndpointMap& endpoints,
+        const GuidPrefix_t& prefix)
+{
+    typename EndpointMap::iterator first = endpoints.lower_bound(GUID_t(prefix, c_EntityId_Unknown));
+    typename EndpointMap::iterator last = first;
+
+    while (last != endpoints.end() && last->first.guidPrefix == prefix)
+    {
+        ++last;
+    }
+
+    endpoints.erase(first, last);
+}
+
+} // namespace
+
 /*static members*/
 TopicDescriptionItem DiscoveryServerManager::default_topic_description("HelloWorldTopic", "HelloWorld");
 const std::regex DiscoveryServerManager::ipv4_regular_expression("^((?:[0-9]{1,3}\\.){3}[0-9]{1,3})?:?(?:(\\d+))?$");
@@ -60,7 +94,9 @@ const std::chrono::seconds DiscoveryServerManager::last_snapshot_delay_ = std::c
 
 DiscoveryServerManager::DiscoveryServerManager(
         const std::string& xml_file_path,
-        const bool shared_memory_off)
+        const bool shared_memory_off,
+        SnapshotFilter snapshot_filter,
+        IngestionMode ingestion_mode)
     : no_callbacks(false)
     , auto_shutdown(true)
     , enable_prefix_validation(true)
@@ -70,26 +106,25 @@ DiscoveryServerManager::DiscoveryServerManager(
     , shared_memory_off_(shared_memory_off)
 {
     tinyxml2::XMLDocument doc;
+    snapshot_filter_ = std::move(snapshot_filter);
+
+    // snapshot files are loaded without building a document
+    if (BinarySnapshotFile::Probe(xml_file_path) || SnapshotXmlReader::Probe(xml_file_path))
+    {
+        loadSnapshots(xml_file_path);
+        validate_ = true;
+        auto_shutdown = true;
+        LOG_INFO("Loaded snapshot file");
+        return;
+    }
 
     if (tinyxml2::XMLError::XML_SUCCESS == doc.LoadFile(xml_file_path.c_str()))
     {
         tinyxml2::XMLElement* root = doc.FirstChildElement(s_sDS.c_str());
         if (root == nullptr)
         {
-            root = doc.FirstChildElement(s_sDS_Snapshots.c_str());
-            if (root == nullptr)
-            {
-                LOG_ERROR("Invalid config or snapshot file");
-                return;
-            }
-            else
-            {
-                loadSnapshots(xml_file_path);
-                validate_ = true;
-                auto_shutdown = true;
-                LOG_INFO("Loaded snapshot file");
-                return;
-            }
+            LOG_ERROR("Invalid config or snapshot file");
+            return;
         }
 
         // config file, we must validate
@@ -101,6 +136,43 @@ DiscoveryServerManager::DiscoveryServerManager(
         // try load the enable_prefix_validation attribute
         enable_prefix_validation = root->BoolAttribute(s_sPrefixValidation.c_str(), enable_prefix_validation);
 
+        // try load the ingestion_queue and staging_buffers attributes, callbacks would not modify the state directly
+        bool ingestion_queue = root->BoolAttribute(s_sIngestionQueue.c_str(), false);
+        bool staging_buffers = root->BoolAttribute(s_sStagingBuffers.c_str(), false);
+
+        // the command line mode replaces the config file one
+        if (ingestion_mode != IngestionMode::CONFIG)
+        {
+            ingestion_queue = ingestion_mode == IngestionMode::INGESTION_QUEUE;
+            staging_buffers = ingestion_mode == IngestionMode::STAGING_BUFFERS;
+        }
+
+        if (ingestion_queue && staging_buffers)
+        {
+            LOG_ERROR("ingestion_queue and staging_buffers are exclusive, using the ingestion queue");
+        }
+
+        if (ingestion_queue)
+        {
+            ingestion_.reset(new DiscoveryEventQueue(state));
+        }
+        else if (staging_buffers)
+        {
+            ingestion_.reset(new DiscoveryStagingBuffers(state));
+        }
+
+        // try load the zombie_grace_period attribute, in seconds
+        int zombie_grace = root->IntAttribute(s_sZombieGracePeriod.c_str(), 0);
+
+        if (zombie_grace < 0)
+        {
+            LOG_ERROR(s_sZombieGracePeriod << " must be a non negative number of seconds");
+        }
+        else
+        {
+            zombie_grace_period(std::chrono::seconds(zombie_grace));
+        }
+
         for (auto child = doc.FirstChildElement(s_sDS.c_str());
                 child != nullptr; child = child->NextSiblingElement(s_sDS.c_str()))
         {
@@ -289,58 +361,90 @@ void DiscoveryServerManager::runEvents(
     }
 }
 
+void DiscoveryServerManager::addParticipant(
+        DomainParticipant* p,
+        ParticipantRole role)
+{
+    if (p == nullptr)
+    {
+        LOG_ERROR("Error adding Participant. Null pointer");
+        return;
+    }
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+    bool inserted = participants.emplace(p->guid(), ParticipantRegistryEntry(role, p)).second;
+    assert(inserted);
+    (void)inserted;
+}
+
+ParticipantRegistryEntry* DiscoveryServerManager::findParticipant(
+        const GUID_t& id)
+{
+    participant_registry::iterator it = participants.find(id);
+    if (it != participants.end())
+    {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+
+std::string DiscoveryServerManager::participantLabel(
+        const GUID_t& id)
+{
+    if (!no_callbacks)
+    {
+        // is one of ours?
+        ParticipantRegistryEntry* entry = findParticipant(id);
+        if (entry != nullptr)
+        {
+            return entry->name;
+        }
+    }
+    else
+    {
+        // stick to non-DiscoveryServerManager info
+        for (const ParticipantDiscoveryItem* p : state.FindParticipant(id))
+        {
+            if (!p->participant_name.empty())
+            {
+                return p->participant_name;
+            }
+        }
+    }
+
+    // if remote use prefix instead of name
+    std::ostringstream ss;
+    ss << id;
+    return ss.str();
+}
+
 void DiscoveryServerManager::addServer(
         DomainParticipant* s)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    assert(servers[s->guid()] == nullptr);
-    servers[s->guid()] = s;
+    addParticipant(s, ParticipantRole::SERVER);
 }
 
 void DiscoveryServerManager::addClient(
         DomainParticipant* c)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    assert(clients[c->guid()] == nullptr);
-    clients[c->guid()] = c;
+    addParticipant(c, ParticipantRole::CLIENT);
 }
 
 void DiscoveryServerManager::addSimple(
         DomainParticipant* s)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    assert(simples[s->guid()] == nullptr);
-    simples[s->guid()] = s;
+    addParticipant(s, ParticipantRole::SIMPLE);
 }
 
 DomainParticipant* DiscoveryServerManager::getParticipant(
         GUID_t& id)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
 
-    created_entity_map::iterator iter = std::find_if(entity_map.begin(), entity_map.end(),
-                    [id](const std::pair<GUID_t, ParticipantCreatedEntityInfo> info)
-                    {
-                        return info.first == id;
-                    } );
-    if (iter != entity_map.end())
+    ParticipantRegistryEntry* entry = findParticipant(id);
+    if (entry != nullptr)
     {
-        return iter->second.participant;
-    }
-
-    // first in clients
-    participant_map::iterator it = clients.find(id);
-    if (it != clients.end())
-    {
-        return it->second;
-    }
-    else if ((it = servers.find(id)) != servers.end())
-    {
-        return it->second;
-    }
-    else if ((it = simples.find(id)) != simples.end())
-    {
-        return it->second;
+        return entry->info.participant;
     }
 
     return nullptr;
@@ -349,7 +453,11 @@ DomainParticipant* DiscoveryServerManager::getParticipant(
 DomainParticipant* DiscoveryServerManager::removeParticipant(
         GUID_t& id)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    // all callbacks received before the removal must be reflected, flushed before locking as callbacks would
+    // stall behind the flush otherwise
+    syncState();
+
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     DomainParticipant* ret = nullptr;
 
@@ -360,40 +468,14 @@ DomainParticipant* DiscoveryServerManager::removeParticipant(
         LOG_ERROR("Error during database deletion" << id);
     }
     // remove any related datareaders/writers
-    {
-        data_writer_map paux;
-        std::remove_copy_if(data_writers.begin(), data_writers.end(), std::inserter(paux, paux.begin()),
-                [&id](data_writer_map::value_type it)
-                {
-                    return id.guidPrefix == it.first.guidPrefix;
-                });
-        data_writers.swap(paux);
+    erase_prefix(data_writers, id.guidPrefix);
+    erase_prefix(data_readers, id.guidPrefix);
 
-        data_reader_map saux;
-        std::remove_copy_if(data_readers.begin(), data_readers.end(), std::inserter(saux, saux.begin()),
-                [&id](data_reader_map::value_type it)
-                {
-                    return id.guidPrefix == it.first.guidPrefix;
-                });
-        data_readers.swap(saux);
-    }
-
-    // first in clients
-    participant_map::iterator it = clients.find(id);
-    if (it != clients.end())
-    {
-        ret = it->second;
-        clients.erase(it);
-    }
-    else if ((it = servers.find(id)) != servers.end())
+    participant_registry::iterator it = participants.find(id);
+    if (it != participants.end())
     {
-        ret = it->second;
-        servers.erase(it);
-    }
-    else if ((it = simples.find(id)) != simples.end())
-    {
-        ret = it->second;
-        simples.erase(it);
+        ret = it->second.info.participant;
+        participants.erase(it);
     }
 
     return ret;
@@ -407,7 +489,7 @@ void DiscoveryServerManager::addDataReader(
         LOG_ERROR("Error adding DataReader. Null pointer");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
     assert(data_readers[dr->guid()] == nullptr);
     data_readers[dr->guid()] = dr;
 }
@@ -415,7 +497,7 @@ void DiscoveryServerManager::addDataReader(
 DataReader* DiscoveryServerManager::getDataReader(
         GUID_t& id)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
 
     data_reader_map::iterator it = data_readers.find(id);
     if (it != data_readers.end())
@@ -429,7 +511,7 @@ DataReader* DiscoveryServerManager::getDataReader(
 DataReader* DiscoveryServerManager::removeSubscriber(
         GUID_t& id)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     DataReader* ret = nullptr;
 
@@ -452,9 +534,12 @@ ReturnCode_t DiscoveryServerManager::deleteDataReader(
     }
     fastdds::dds::Subscriber* sub = nullptr;
     {
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
-        GUID_t participant_guid = dr->get_subscriber()->get_participant()->guid();
-        sub = entity_map[participant_guid].subscriber;
+        std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
+        ParticipantRegistryEntry* entry = findParticipant(dr->get_subscriber()->get_participant()->guid());
+        if (entry != nullptr)
+        {
+            sub = entry->info.subscriber;
+        }
     }
     if (sub != nullptr)
     {
@@ -472,9 +557,12 @@ ReturnCode_t DiscoveryServerManager::deleteDataWriter(
     }
     fastdds::dds::Publisher* pub = nullptr;
     {
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
-        GUID_t participant_guid = dw->get_publisher()->get_participant()->guid();
-        pub = entity_map[participant_guid].publisher;
+        std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
+        ParticipantRegistryEntry* entry = findParticipant(dw->get_publisher()->get_participant()->guid());
+        if (entry != nullptr)
+        {
+            pub = entry->info.publisher;
+        }
     }
     if (pub != nullptr)
     {
@@ -492,10 +580,13 @@ ReturnCode_t DiscoveryServerManager::deleteParticipant(
             return RETCODE_ERROR;
         }
 
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
-        participant->set_listener(nullptr);
+        {
+            std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+            participants.erase(participant->guid());
+        }
 
-        entity_map.erase(participant->guid());
+        // callbacks triggered from here take the shared lock, keep the exclusive one released
+        participant->set_listener(nullptr);
 
         ReturnCode_t ret = participant->delete_contained_entities();
         if (ret != RETCODE_OK)
@@ -524,8 +615,14 @@ void DiscoveryServerManager::setDomainEntityTopic(
         LOG_ERROR("Error setting Domain Entity Topic. Null DataWriter Topic");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    entity_map[entity->get_publisher()->get_participant()->guid()].publisherTopic = t;
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(entity->get_publisher()->get_participant()->guid());
+    if (entry == nullptr)
+    {
+        LOG_ERROR("Error setting Domain Entity Topic. Unknown DataWriter Participant");
+        return;
+    }
+    entry->info.publisherTopic = t;
 }
 
 template<>
@@ -543,8 +640,14 @@ void DiscoveryServerManager::setDomainEntityTopic(
         LOG_ERROR("Error setting Domain Entity Topic. Null DataReader Topic");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    entity_map[entity->get_subscriber()->get_participant()->guid()].subscriberTopic = t;
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(entity->get_subscriber()->get_participant()->guid());
+    if (entry == nullptr)
+    {
+        LOG_ERROR("Error setting Domain Entity Topic. Unknown DataReader Participant");
+        return;
+    }
+    entry->info.subscriberTopic = t;
 }
 
 template<>
@@ -562,8 +665,14 @@ void DiscoveryServerManager::setDomainEntityType(
         LOG_ERROR("Error setting Domain Entity Topic. Null Publisher Topic Datatype");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    entity_map[entity->get_participant()->guid()].publisherType = t;
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(entity->get_participant()->guid());
+    if (entry == nullptr)
+    {
+        LOG_ERROR("Error setting Domain Entity Topic. Unknown Publisher Participant");
+        return;
+    }
+    entry->info.publisherType = t;
 }
 
 template<>
@@ -581,8 +690,14 @@ void DiscoveryServerManager::setDomainEntityType(
         LOG_ERROR("Error setting Domain Entity Topic. Null Subscriber Topic Datatype");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    entity_map[entity->get_participant()->guid()].subscriberType = t;
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(entity->get_participant()->guid());
+    if (entry == nullptr)
+    {
+        LOG_ERROR("Error setting Domain Entity Topic. Unknown Subscriber Participant");
+        return;
+    }
+    entry->info.subscriberType = t;
 }
 
 void DiscoveryServerManager::addDataWriter(
@@ -593,7 +708,7 @@ void DiscoveryServerManager::addDataWriter(
         LOG_ERROR("Error adding DataWriter. Null pointer");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
     assert(data_writers[dw->guid()] == nullptr);
     data_writers[dw->guid()] = dw;
 }
@@ -601,7 +716,7 @@ void DiscoveryServerManager::addDataWriter(
 DataWriter* DiscoveryServerManager::getDataWriter(
         GUID_t& id)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
 
     data_writer_map::iterator it = data_writers.find(id);
     if (it != data_writers.end())
@@ -615,7 +730,7 @@ DataWriter* DiscoveryServerManager::getDataWriter(
 DataWriter* DiscoveryServerManager::removePublisher(
         GUID_t& id)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     DataWriter* ret = nullptr;
 
@@ -634,8 +749,9 @@ void DiscoveryServerManager::getPubSubEntityFromParticipantGuid< eprosima::fastd
         GUID_t& id,
         DomainEntity*& pubsub)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    pubsub = entity_map[id].publisher;
+    std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(id);
+    pubsub = entry != nullptr ? entry->info.publisher : nullptr;
 }
 
 template<>
@@ -643,16 +759,23 @@ void DiscoveryServerManager::getPubSubEntityFromParticipantGuid< eprosima::fastd
         GUID_t& id,
         DomainEntity*& pubsub)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    pubsub = entity_map[id].subscriber;
+    std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(id);
+    pubsub = entry != nullptr ? entry->info.subscriber : nullptr;
 }
 
 void DiscoveryServerManager::setParticipantInfo(
         GUID_t& guid,
         ParticipantCreatedEntityInfo& info)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
-    entity_map[guid] = info;
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+    ParticipantRegistryEntry* entry = findParticipant(guid);
+    if (entry == nullptr)
+    {
+        LOG_ERROR("Error setting Participant Info. Unknown Participant " << guid);
+        return;
+    }
+    entry->info = info;
 }
 
 void DiscoveryServerManager::setParticipantTopic(
@@ -669,12 +792,12 @@ void DiscoveryServerManager::setParticipantTopic(
         LOG_ERROR("Error setting Participant Topic. Null Topic");
         return;
     }
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
-    created_entity_map::iterator it = entity_map.find(p->guid());
-    if (it != entity_map.end())
+    ParticipantRegistryEntry* entry = findParticipant(p->guid());
+    if (entry != nullptr)
     {
-        entity_map[p->guid()].registeredTopics[t->get_name()] = t;
+        entry->info.registeredTopics[t->get_name()] = t;
     }
 }
 
@@ -687,20 +810,21 @@ Topic* DiscoveryServerManager::getParticipantTopicByName(
         LOG_ERROR("Error getting Participant Topic. Null Participant");
         return nullptr;
     }
-    Topic* returnTopic = nullptr;
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
 
-    created_entity_map::iterator it = entity_map.find(p->guid());
-    if (it != entity_map.end())
+    ParticipantRegistryEntry* entry = findParticipant(p->guid());
+    if (entry == nullptr)
     {
-        returnTopic = entity_map[p->guid()].registeredTopics[name];
+        return nullptr;
     }
-    else
+
+    auto it = entry->info.registeredTopics.find(name);
+    if (it == entry->info.registeredTopics.end())
     {
         return nullptr;
     }
 
-    return returnTopic;
+    return it->second;
 }
 
 bool DiscoveryServerManager::fill_topic_description_profile(
@@ -767,7 +891,7 @@ void DiscoveryServerManager::onTerminate()
 {
     {
         // make sure all other threads don't modify the state
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
+        std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
         if (no_callbacks)
         {
@@ -778,63 +902,49 @@ void DiscoveryServerManager::onTerminate()
 
     }
 
+    // reaping would race with the participants destruction
+    stopReaper();
+    LOG_INFO("Zombies " << state.GetZombieStatistics());
+
     // IMPORTANT: Clear first all clients before cleaning servers
-    // Remove all clients
-    for (const auto& entity: clients)
+    // Simple participants could become Clients, so they should be deleted before Servers
+    for (ParticipantRole role : {ParticipantRole::CLIENT, ParticipantRole::SIMPLE, ParticipantRole::SERVER})
     {
-        entity.second->set_listener(nullptr);
-
-        ReturnCode_t ret = entity.second->delete_contained_entities();
-        if (RETCODE_OK != ret)
+        for (const auto& entity: participants)
         {
-            LOG_ERROR("Error cleaning up client entities");
-        }
-
-        ret = DomainParticipantFactory::get_instance()->delete_participant(entity.second);
-        if (RETCODE_OK != ret)
-        {
-            LOG_ERROR("Error deleting Client");
-        }
-    }
+            if (entity.second.role != role)
+            {
+                continue;
+            }
 
-    // Remove all simple participants
-    // Simple participants could become Clients, so they should be deleted before Servers
-    for (const auto& entity: simples)
-    {
-        entity.second->set_listener(nullptr);
+            DomainParticipant* participant = entity.second.info.participant;
+            participant->set_listener(nullptr);
 
-        ReturnCode_t ret = entity.second->delete_contained_entities();
-        if (RETCODE_OK != ret)
-        {
-            LOG_ERROR("Error cleaning up simple entities");
-        }
+            ReturnCode_t ret = participant->delete_contained_entities();
+            if (RETCODE_OK != ret)
+            {
+                LOG_ERROR("Error cleaning up " << role << " entities");
+            }
 
-        ret = DomainParticipantFactory::get_instance()->delete_participant(entity.second);
-        if (RETCODE_OK != ret)
-        {
-            LOG_ERROR("Error deleting Simple Discovery Entity");
+            ret = DomainParticipantFactory::get_instance()->delete_participant(participant);
+            if (RETCODE_OK != ret)
+            {
+                LOG_ERROR("Error deleting " << role << " " << entity.second.name);
+            }
         }
     }
 
-    // Remove all servers
-    for (const auto& entity: servers)
     {
-        entity.second->set_listener(nullptr);
-
-        ReturnCode_t ret = entity.second->delete_contained_entities();
-        if (RETCODE_OK != ret)
-        {
-            LOG_ERROR("Error cleaning up server entities");
-        }
-
-        ret = DomainParticipantFactory::get_instance()->delete_participant(entity.second);
-        if (RETCODE_OK != ret)
-        {
-            LOG_ERROR("Error deleting Server");
-        }
+        std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
+        participants.clear();
     }
 
-    entity_map.clear();
+    if (ingestion_)
+    {
+        // no more callbacks, apply the pending ones
+        ingestion_->flush();
+        LOG_INFO("Ingestion " << *ingestion_);
+    }
 
     data_readers.clear();
 
@@ -851,6 +961,8 @@ void DiscoveryServerManager::onTerminate()
 
 DiscoveryServerManager::~DiscoveryServerManager()
 {
+    stopReaper();
+
     if (!snapshots_output_file.empty())
     {
         saveSnapshots(snapshots_output_file);
@@ -926,8 +1038,7 @@ void DiscoveryServerManager::loadServer(
     const char* cprefix = server->Attribute(DSxmlparser::PREFIX);
 
     if (cprefix != nullptr &&
-            !(std::istringstream(cprefix) >> prefix) &&
-            (prefix == c_GuidPrefix_Unknown))
+            !guid_codec::Decode(cprefix, prefix))
     {
         LOG_ERROR("Servers cannot have a framework provided prefix"); // at least for now
         return;
@@ -936,11 +1047,16 @@ void DiscoveryServerManager::loadServer(
     GUID_t guid(prefix, c_EntityId_RTPSParticipant);
 
     // Check if the guidPrefix is already in use (there is a mistake on config file)
-    if (enable_prefix_validation &&
-            servers.find(guid) != servers.end())
+    if (enable_prefix_validation)
     {
-        LOG_ERROR("DiscoveryServerManager detected two servers sharing the same prefix " << prefix);
-        return;
+        std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
+        ParticipantRegistryEntry* entry = findParticipant(guid);
+
+        if (entry != nullptr && entry->role == ParticipantRole::SERVER)
+        {
+            LOG_ERROR("DiscoveryServerManager detected two servers sharing the same prefix " << prefix);
+            return;
+        }
     }
 
     // replace the DomainParticipantQOS builtin lists with the ones from server_locators (if present)
@@ -1548,7 +1664,7 @@ std::chrono::steady_clock::time_point DiscoveryServerManager::getTime() const
 void DiscoveryServerManager::loadSnapshot(
         tinyxml2::XMLElement* snapshot)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     // snapshots are created for debugging purposes
     // time is mandatory
@@ -1583,7 +1699,7 @@ void DiscoveryServerManager::loadSnapshot(
 void DiscoveryServerManager::loadEnvironmentChange(
         tinyxml2::XMLElement* change)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     // snapshots are created for debugging purposes
     // time is mandatory
@@ -1617,7 +1733,7 @@ void DiscoveryServerManager::loadEnvironmentChange(
 void DiscoveryServerManager::MapServerInfo(
         tinyxml2::XMLElement* server)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     // profile name is mandatory
     std::string profile_name(server->Attribute(DSxmlparser::PROFILE_NAME));
@@ -1648,7 +1764,7 @@ void DiscoveryServerManager::MapServerInfo(
 
     if (cprefix != nullptr)
     {
-        std::istringstream(cprefix) >> prefix;
+        guid_codec::Decode(cprefix, prefix);
     }
     else
     {
@@ -1681,32 +1797,36 @@ void DiscoveryServerManager::on_participant_discovery(
     const GUID_t& partid = info.guid;
     static_cast<void>(should_be_ignored);
 
-    // if the callback origin was removed ignore
     GUID_t srcGuid = participant->guid();
-    std::string srcName = participant->get_qos().name().to_string();
-    if ( nullptr == getParticipant(srcGuid))
-    {
-        LOG_INFO("Received onParticipantDiscovery callback from unknown participant: " << srcGuid);
-        return;
-    }
-
-    LOG_INFO("Participant " << participant->get_qos().name().to_string() << " reports a participant "
-                            << info.participant_name << " is " << status << ". Prefix " << partid);
+    InternedString srcName;
 
     std::chrono::steady_clock::time_point callback_time = std::chrono::steady_clock::now();
     {
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
+        std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
+
+        // if the callback origin was removed ignore
+        ParticipantRegistryEntry* src = findParticipant(srcGuid);
+        if (nullptr == src)
+        {
+            LOG_INFO("Received onParticipantDiscovery callback from unknown participant: " << srcGuid);
+            return;
+        }
+        srcName = src->symbol;
 
         // update last_callback time
-        last_PDP_callback_ = callback_time;
+        last_PDP_callback_.store(callback_time, std::memory_order_relaxed);
 
         if (!no_callbacks)
         {
             // DiscoveryServerManager info still valid
-            server = servers.end() != servers.find(partid);
+            ParticipantRegistryEntry* entry = findParticipant(partid);
+            server = entry != nullptr && entry->role == ParticipantRole::SERVER;
         }
     }
 
+    LOG_INFO("Participant " << srcName << " reports a participant "
+                            << info.participant_name << " is " << status << ". Prefix " << partid);
+
     // add to database, it has its own mtx
     // note that when a participant is destroyed he will wait for all his callbacks to return
     // state will be alive during all callbacks
@@ -1714,14 +1834,14 @@ void DiscoveryServerManager::on_participant_discovery(
     {
         case ParticipantDiscoveryStatus::DISCOVERED_PARTICIPANT:
         {
-            state.AddParticipant(srcGuid, srcName, partid, info.participant_name.to_string(), callback_time,
-                    server);
+            ingest(DiscoveryEvent::AddParticipant(srcGuid, srcName, partid, info.participant_name.to_string(),
+                    callback_time, server));
             break;
         }
         case ParticipantDiscoveryStatus::REMOVED_PARTICIPANT:
         case ParticipantDiscoveryStatus::DROPPED_PARTICIPANT:
         {
-            state.RemoveParticipant(srcGuid, partid);
+            ingest(DiscoveryEvent::RemoveParticipant(srcGuid, partid));
             break;
         }
         default:
@@ -1738,77 +1858,53 @@ void DiscoveryServerManager::on_data_reader_discovery(
     static_cast<void>(should_be_ignored);
     typedef ReaderDiscoveryStatus DS;
 
-    // if the callback origin was removed ignore
     GUID_t srcGuid = participant->guid();
-    std::string srcName = participant->get_qos().name().to_string();
-    if ( nullptr == getParticipant(srcGuid))
-    {
-        LOG_INFO("Received SubscriberDiscovery callback from unknown participant: " << srcGuid);
-        return;
-    }
+    InternedString srcName;
 
     const GUID_t& subsid = info.guid;
     GUID_t partid = info.participant_guid;
 
-    // non reported info
-    std::string part_name;
-
     std::chrono::steady_clock::time_point callback_time = std::chrono::steady_clock::now();
     {
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
-
-        // update last_callback time
-        last_EDP_callback_ = callback_time;
-
-        participant_map::iterator it;
+        std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
 
-        if (!no_callbacks)
-        {
-            // is one of ours?
-            if ((it = servers.find(partid)) != servers.end() ||
-                    (it = clients.find(partid)) != clients.end() ||
-                    (it = simples.find(partid)) != simples.end())
-            {
-                part_name = it->second->get_qos().name().to_string();
-            }
-        }
-        else
+        // if the callback origin was removed ignore
+        ParticipantRegistryEntry* src = findParticipant(srcGuid);
+        if (nullptr == src)
         {
-            // stick to non-DiscoveryServerManager info
-            for (const ParticipantDiscoveryItem* p : state.FindParticipant(partid))
-            {
-                if (!p->participant_name.empty())
-                {
-                    part_name = p->participant_name;
-                }
-            }
+            LOG_INFO("Received SubscriberDiscovery callback from unknown participant: " << srcGuid);
+            return;
         }
-    }
+        srcName = src->symbol;
 
-    if (part_name.empty())
-    {
-        // if remote use prefix instead of name
-        std::ostringstream ss;
-        ss << partid;
-        part_name = ss.str();
+        // update last_callback time
+        last_EDP_callback_.store(callback_time, std::memory_order_relaxed);
+
+        // the reported participant is resolved under the same lock
+        LOG_INFO("Participant " << srcName << " reports a subscriber of participant "
+                                << participantLabel(partid) << " is " << reason << " with typename: " << info.type_name
+                                << " topic: " << info.topic_name << " GUID: " << subsid);
     }
 
     switch (reason)
     {
         case DS::DISCOVERED_READER:
-            state.AddDataReader(srcGuid, srcName, partid, subsid, info.type_name.to_string(),
-                    info.topic_name.to_string(), callback_time);
+            try
+            {
+                ingest(DiscoveryEvent::AddDataReader(srcGuid, srcName, partid, subsid, intern(info.type_name),
+                        intern(info.topic_name), callback_time));
+            }
+            catch (const std::length_error& e)
+            {
+                LOG_ERROR("Subscriber " << subsid << " discarded: " << e.what());
+            }
             break;
         case DS::REMOVED_READER:
-            state.RemoveDataReader(srcGuid, partid, subsid);
+            ingest(DiscoveryEvent::RemoveDataReader(srcGuid, partid, subsid));
             break;
         default:
             break;
     }
-
-    LOG_INFO("Participant " << participant->get_qos().name().to_string() << " reports a subscriber of participant "
-                            << part_name << " is " << reason << " with typename: " << info.type_name
-                            << " topic: " << info.topic_name << " GUID: " << subsid);
 }
 
 void DiscoveryServerManager::on_data_writer_discovery(
@@ -1820,91 +1916,159 @@ void DiscoveryServerManager::on_data_writer_discovery(
     should_be_ignored = false;
     typedef WriterDiscoveryStatus DS;
 
-    // if the callback origin was removed ignore
     GUID_t srcGuid = participant->guid();
-    std::string srcName = participant->get_qos().name().to_string();
-    if ( nullptr == getParticipant(srcGuid))
-    {
-        LOG_INFO("Received PublisherDiscovery callback from unknown participant: " << srcGuid);
-        return;
-    }
+    InternedString srcName;
 
     const GUID_t& pubsid = info.guid;
     GUID_t partid = info.participant_guid;
 
-    // non reported info
-    std::string part_name;
-
     std::chrono::steady_clock::time_point callback_time = std::chrono::steady_clock::now();
     {
-        std::lock_guard<std::recursive_mutex> lock(management_mutex);
-
-        // update last_callback time
-        last_EDP_callback_ = callback_time;
+        std::shared_lock<std::shared_timed_mutex> lock(management_mutex);
 
-        if (!no_callbacks)
+        // if the callback origin was removed ignore
+        ParticipantRegistryEntry* src = findParticipant(srcGuid);
+        if (nullptr == src)
         {
-            // is one of ours?
-            participant_map::iterator it;
-
-            if ((it = servers.find(partid)) != servers.end() ||
-                    (it = clients.find(partid)) != clients.end() ||
-                    (it = simples.find(partid)) != simples.end())
-            {
-                part_name = it->second->get_qos().name().to_string();
-            }
-        }
-        else
-        {
-            // stick to non-DiscoveryServerManager info
-            for (const ParticipantDiscoveryItem* p : state.FindParticipant(partid))
-            {
-                if (!p->participant_name.empty())
-                {
-                    part_name = p->participant_name;
-                }
-            }
+            LOG_INFO("Received PublisherDiscovery callback from unknown participant: " << srcGuid);
+            return;
         }
-    }
+        srcName = src->symbol;
 
-    if (part_name.empty())
-    {
-        // if remote use prefix instead of name
-        std::ostringstream ss;
-        ss << partid;
-        part_name = ss.str();
+        // update last_callback time
+        last_EDP_callback_.store(callback_time, std::memory_order_relaxed);
+
+        // the reported participant is resolved under the same lock
+        LOG_INFO("Participant " << srcName << " reports a publisher of participant "
+                                << participantLabel(partid) << " is " << reason << " with typename: " << info.type_name
+                                << " topic: " << info.topic_name << " GUID: " << pubsid);
     }
 
     switch (reason)
     {
         case DS::DISCOVERED_WRITER:
 
-            state.AddDataWriter(srcGuid,
-                    srcName,
-                    partid,
-                    pubsid,
-                    info.type_name.to_string(),
-                    info.topic_name.to_string(),
-                    callback_time);
+            try
+            {
+                ingest(DiscoveryEvent::AddDataWriter(srcGuid,
+                        srcName,
+                        partid,
+                        pubsid,
+                        intern(info.type_name),
+                        intern(info.topic_name),
+                        callback_time));
+            }
+            catch (const std::length_error& e)
+            {
+                LOG_ERROR("Publisher " << pubsid << " discarded: " << e.what());
+            }
             break;
         case DS::REMOVED_WRITER:
 
-            state.RemoveDataWriter(srcGuid, partid, pubsid);
+            ingest(DiscoveryEvent::RemoveDataWriter(srcGuid, partid, pubsid));
             break;
         default:
             break;
     }
-
-    LOG_INFO("Participant " << participant->get_qos().name().to_string() << " reports a publisher of participant "
-                            << part_name << " is " << reason << " with typename: " << info.type_name
-                            << " topic: " << info.topic_name << " GUID: " << pubsid);
 }
 
 void DiscoveryServerManager::on_liveliness_changed(
         DataReader* sub,
         const LivelinessChangedStatus& status)
 {
-    state.UpdateSubLiveliness(sub->guid(), status.alive_count, status.not_alive_count);
+    ingest(DiscoveryEvent::UpdateSubLiveliness(sub->guid(), status.alive_count, status.not_alive_count));
+}
+
+void DiscoveryServerManager::ingest(
+        DiscoveryEvent&& event)
+{
+    if (ingestion_)
+    {
+        ingestion_->push(std::move(event));
+    }
+    else
+    {
+        event.apply(state);
+    }
+}
+
+void DiscoveryServerManager::zombie_grace_period(
+        std::chrono::seconds grace)
+{
+    stopReaper();
+
+    if (grace.count() > 0)
+    {
+        reaper_stop_ = false;
+        reaper_ = std::thread(&DiscoveryServerManager::runReaper, this, grace);
+    }
+}
+
+void DiscoveryServerManager::stopReaper()
+{
+    if (!reaper_.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(reaper_mutex_);
+        reaper_stop_ = true;
+    }
+
+    reaper_cv_.notify_one();
+    reaper_.join();
+}
+
+void DiscoveryServerManager::runReaper(
+        std::chrono::seconds grace)
+{
+    // a zombie outlives its grace period at most by the reaping period
+    std::chrono::milliseconds period = std::max<std::chrono::milliseconds>(grace / 2, std::chrono::seconds(1));
+
+    std::unique_lock<std::mutex> lock(reaper_mutex_);
+
+    while (!reaper_cv_.wait_for(lock, period, [this]()
+            {
+                return reaper_stop_;
+            }))
+    {
+        lock.unlock();
+
+        // pending endpoint removals may already dispose of some zombies
+        syncState();
+        std::size_t reaped = state.ReapZombies(grace);
+        LOG_INFO("Zombie reaper removed " << reaped << " participants. " << state.GetZombieStatistics());
+
+        lock.lock();
+    }
+}
+
+void DiscoveryServerManager::syncState() const
+{
+    if (ingestion_)
+    {
+        ingestion_->flush();
+    }
+}
+
+std::ostream& eprosima::discovery_server::operator <<(
+        std::ostream& o,
+        ParticipantRole r)
+{
+    switch (r)
+    {
+        case ParticipantRole::SERVER:
+            return o << "server";
+        case ParticipantRole::CLIENT:
+            return o << "client";
+        case ParticipantRole::SIMPLE:
+            return o << "simple";
+        default: // unknown value, error
+            o.setstate(std::ios::failbit);
+    }
+
+    return o;
 }
 
 std::ostream& eprosima::discovery_server::operator <<(
@@ -1973,6 +2137,7 @@ std::ostream& eprosima::discovery_server::operator <<(
 bool DiscoveryServerManager::allKnowEachOther() const
 {
     // Get a copy of current state
+    syncState();
     Snapshot shot = state.GetState();
     return allKnowEachOther(shot);
 }
@@ -1983,40 +2148,34 @@ Snapshot& DiscoveryServerManager::takeSnapshot(
         bool someone,
         bool show_liveliness)
 {
-    std::lock_guard<std::recursive_mutex> lock(management_mutex);
+    // all callbacks received before the request must be reflected, flushed before locking as callbacks would
+    // stall behind the flush otherwise
+    syncState();
+
+    // the snapshots list is modified
+    std::lock_guard<std::shared_timed_mutex> lock(management_mutex);
 
     snapshots.push_back(state.GetState());
 
     Snapshot& shot = snapshots.back();
     shot._time = tp;
-    shot.last_PDP_callback_ = last_PDP_callback_;
-    shot.last_EDP_callback_ = last_EDP_callback_;
+    shot.last_PDP_callback_ = last_PDP_callback_.load(std::memory_order_relaxed);
+    shot.last_EDP_callback_ = last_EDP_callback_.load(std::memory_order_relaxed);
     shot._des = desc;
     shot.if_someone = someone;
     shot.show_liveliness_ = show_liveliness;
 
     // Add any simple, client or server isolated information
     // those have not make any callbacks if no subscriber or publisher
+    for (const auto& p : participants)
+    {
+        Snapshot::iterator it = shot.lower_bound(p.first);
 
-    participant_map temp(servers);
-    temp.insert(clients.begin(), clients.end());
-    temp.insert(simples.begin(), simples.end());
-
-    std::function<bool(const participant_map::value_type&, const Snapshot::value_type&)> pred(
-        [](const participant_map::value_type& p1, const Snapshot::value_type& p2)
+        if (it == shot.end() || *it != p.first)
         {
-            return p1.first == p2.endpoint_guid;
+            // participant hasn't any discovery info in this Snapshot
+            shot.emplace_hint(it, ParticipantDiscoveryDatabase(p.first));
         }
-        );
-
-    std::pair<participant_map::const_iterator, Snapshot::const_iterator> res =
-            std::mismatch(temp.cbegin(), temp.cend(), shot.cbegin(), shot.cend(), pred);
-
-    while (res.first != temp.end())
-    {
-        // res.first participant hasn't any discovery info in this Snapshot
-        res.second = shot.emplace_hint(res.second, ParticipantDiscoveryDatabase(res.first->first));
-        res = std::mismatch(res.first, temp.cend(), res.second, shot.cend(), pred);
     }
 
     return shot;
@@ -2091,21 +2250,46 @@ std::string DiscoveryServerManager::successMessage()
 bool DiscoveryServerManager::loadSnapshots(
         const std::string& file)
 {
-    using namespace tinyxml2;
-    XMLDocument xmlDoc;
+    snapshots_list loaded;
+    std::size_t skipped = 0;
 
-    if (tinyxml2::XML_SUCCESS != xmlDoc.LoadFile(file.c_str()))
+    if (BinarySnapshotFile::Probe(file))
     {
-        LOG_ERROR("Couldn't parse the file: " << file);
-        return false;
+        BinarySnapshotFile mapping(file);
+
+        if (!mapping.Valid())
+        {
+            return false;
+        }
+
+        for (const snapshot_binary::SnapshotRecord& rec : mapping.Snapshots())
+        {
+            // the description is checked in place, rejected snapshots are never built
+            if (snapshot_filter_ && !snapshot_filter_(mapping.String(rec.description)))
+            {
+                ++skipped;
+                continue;
+            }
+
+            loaded.push_back(mapping.ToSnapshot(rec));
+        }
     }
+    else
+    {
+        SnapshotXmlReader reader(snapshot_filter_);
 
-    XMLNode* pRoot = xmlDoc.FirstChildElement(s_sDS_Snapshots.c_str());
+        if (!reader.Load(file, loaded))
+        {
+            LOG_ERROR("Couldn't parse the file: " << file << ". " << reader.Error());
+            return false;
+        }
+
+        skipped = reader.Skipped();
+    }
 
-    if (nullptr == pRoot)
+    if (skipped != 0)
     {
-        LOG_ERROR("Not a valid Snapshot file wrong root element: " << file);
-        return false;
+        LOG_INFO("Skipped " << skipped << " snapshots not requested from " << file);
     }
 
     snapshots_list::iterator it;
@@ -2115,16 +2299,11 @@ bool DiscoveryServerManager::loadSnapshots(
         it = snapshots.begin();
     }
 
-    for (XMLElement* pSh = pRoot->FirstChildElement(s_sDS_Snapshot.c_str());
-            pSh != nullptr;
-            pSh = pSh->NextSiblingElement(s_sDS_Snapshot.c_str()))
+    for (Snapshot& sh : loaded)
     {
-        Snapshot sh;
-        sh.from_xml(pSh);
-
         if (inserter)
         {
-            snapshots.emplace_back(sh);
+            snapshots.emplace_back(std::move(sh));
         }
         else
         {
@@ -2143,32 +2322,27 @@ bool DiscoveryServerManager::loadSnapshots(
 void DiscoveryServerManager::saveSnapshots(
         const std::string& file) const
 {
-    using namespace tinyxml2;
-    XMLDocument xmlDoc;
-
-    // add default comment
-    xmlDoc.InsertFirstChild(xmlDoc.NewDeclaration(nullptr));
-
-    XMLElement* pRoot = xmlDoc.NewElement(s_sDS_Snapshots.c_str());
-    // add the specific schema
-    pRoot->SetAttribute("xmlns", "http://www.eprosima.com/XMLSchemas/ds-snapshot");
-
-    for (const Snapshot& sh : snapshots)
+    if (binary_snapshots_ || HasBinarySnapshotExtension(file))
     {
-        LOG("Saving snapshot " << sh._des);
+        if (SaveBinarySnapshots(file, snapshots))
+        {
+            LOG("Binary snapshot file saved " << file << ".");
+        }
+        else
+        {
+            LOG("Error while saving binary snapshot file " << file);
+        }
 
-        XMLElement* pShRoot = xmlDoc.NewElement(s_sDS_Snapshot.c_str());
-        sh.to_xml(pShRoot, xmlDoc);
-        pRoot->InsertEndChild(pShRoot);
+        return;
     }
-    xmlDoc.InsertEndChild(pRoot);
-    XMLError error = xmlDoc.SaveFile(file.c_str());
-    if (error)
+
+    // streamed, no document is built in memory
+    if (SaveXmlSnapshots(file, snapshots, normalized_snapshots_))
     {
-        LOG("Error while saving snapshot file " << file << ": " << error);
+        LOG("Snapshot file saved " << file << ".");
     }
     else
     {
-        LOG("Snapshot file saved " << file << ".");
+        LOG("Error while saving snapshot file " << file);
     }
 }
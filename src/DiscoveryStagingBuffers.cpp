@@ -0,0 +1,197 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <iterator>
+
+#include "DiscoveryStagingBuffers.h"
+
+using namespace eprosima::discovery_server;
+
+namespace {
+
+std::atomic<uint64_t> s_instances(0);
+
+//! buffers of the calling thread keyed by staging instance, ids are never reused
+struct LocalBuffer
+{
+    uint64_t owner;
+    std::shared_ptr<void> buffer;
+};
+
+thread_local std::vector<LocalBuffer> s_local_buffers;
+
+} // namespace
+
+DiscoveryStagingBuffers::DiscoveryStagingBuffers(
+        DiscoveryItemDatabase& database,
+        std::size_t max_pending)
+    : database_(database)
+    , id_(++s_instances)
+    , max_pending_(std::max<std::size_t>(max_pending, 1))
+{
+}
+
+DiscoveryStagingBuffers::~DiscoveryStagingBuffers()
+{
+    flush();
+}
+
+DiscoveryStagingBuffers::Buffer& DiscoveryStagingBuffers::local()
+{
+    for (const LocalBuffer& local : s_local_buffers)
+    {
+        if (local.owner == id_)
+        {
+            return *static_cast<Buffer*>(local.buffer.get());
+        }
+    }
+
+    // first push from this thread
+    std::shared_ptr<Buffer> buffer = std::make_shared<Buffer>();
+
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+        buffers_.push_back(buffer);
+    }
+
+    s_local_buffers.push_back(LocalBuffer{id_, buffer});
+    return *buffer;
+}
+
+void DiscoveryStagingBuffers::push(
+        DiscoveryEvent&& event)
+{
+    Buffer& buffer = local();
+    bool overflow;
+
+    {
+        // timestamped under the lock, merges rely on it to keep the order
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.events.push_back(Staged{std::chrono::steady_clock::now(), std::move(event)});
+        ++buffer.staged;
+        overflow = buffer.events.size() >= max_pending_;
+    }
+
+    if (overflow)
+    {
+        ++overflow_merges_;
+        flush();
+    }
+}
+
+void DiscoveryStagingBuffers::flush()
+{
+    std::lock_guard<std::mutex> merge_lock(merge_mutex_);
+
+    // only events staged before the cutoff are merged. Events are timestamped under their buffer lock, so any
+    // event pushed after its buffer is drained is later than the cutoff and the next merge cannot get older ones
+    const std::chrono::steady_clock::time_point cutoff = std::chrono::steady_clock::now();
+    std::vector<Staged> pending;
+
+    auto before_cutoff = [](
+                const Staged& s,
+                const std::chrono::steady_clock::time_point& t)
+            {
+                return s.staged_at < t;
+            };
+
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+
+        for (const std::shared_ptr<Buffer>& buffer : buffers_)
+        {
+            std::vector<Staged> events;
+
+            {
+                std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+                std::vector<Staged>& staged = buffer->events;
+
+                // each buffer is sorted by staging time
+                auto end = std::lower_bound(staged.begin(), staged.end(), cutoff, before_cutoff);
+
+                if (end == staged.end())
+                {
+                    events.swap(staged);
+                }
+                else
+                {
+                    std::move(staged.begin(), end, std::back_inserter(events));
+                    staged.erase(staged.begin(), end);
+                }
+            }
+
+            std::move(events.begin(), events.end(), std::back_inserter(pending));
+        }
+    }
+
+    if (pending.empty())
+    {
+        return;
+    }
+
+    // each buffer is already sorted, stability keeps the order of simultaneous events of a thread
+    std::stable_sort(pending.begin(), pending.end(), [](
+                const Staged& a,
+                const Staged& b)
+            {
+                return a.staged_at < b.staged_at;
+            });
+
+    for (Staged& s : pending)
+    {
+        s.event.apply(database_);
+    }
+
+    merged_ += pending.size();
+    ++merges_;
+
+    if (pending.size() > max_merge_)
+    {
+        max_merge_ = pending.size();
+    }
+}
+
+DiscoveryStagingBuffers::Statistics DiscoveryStagingBuffers::statistics() const
+{
+    Statistics stats;
+    stats.staged = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex_);
+
+        for (const std::shared_ptr<Buffer>& buffer : buffers_)
+        {
+            std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+            stats.staged += buffer->staged;
+        }
+
+        stats.buffers = buffers_.size();
+    }
+
+    stats.merged = merged_;
+    stats.merges = merges_;
+    stats.overflow_merges = overflow_merges_;
+    stats.max_merge = max_merge_;
+    return stats;
+}
+
+void DiscoveryStagingBuffers::report(
+        std::ostream& os) const
+{
+    Statistics stats = statistics();
+    os << "staging buffers merged " << stats.merged << " of " << stats.staged << " events from "
+       << stats.buffers << " threads in " << stats.merges << " merges, largest merge " << stats.max_merge
+       << ", overflow merges " << stats.overflow_merges;
+}
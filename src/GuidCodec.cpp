@@ -0,0 +1,189 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "GuidCodec.h"
+
+using namespace eprosima::discovery_server;
+using eprosima::fastdds::rtps::octet;
+
+namespace {
+
+//! lookup tables indexed by octet or character
+struct HexTables
+{
+    char digits[256][2] {};      // zero padded lowercase hex of each octet
+    signed char nibbles[256] {}; // value of each hex digit, -1 otherwise
+    bool blanks[256] {};         // what operator>> skips in the C locale
+
+    constexpr HexTables()
+    {
+        const char hex[] = "0123456789abcdef";
+
+        for (int i = 0; i < 256; ++i)
+        {
+            digits[i][0] = hex[i >> 4];
+            digits[i][1] = hex[i & 0xf];
+            nibbles[i] = -1;
+            blanks[i] = false;
+        }
+
+        for (int i = 0; i < 10; ++i)
+        {
+            nibbles['0' + i] = static_cast<signed char>(i);
+        }
+
+        for (int i = 0; i < 6; ++i)
+        {
+            nibbles['a' + i] = nibbles['A' + i] = static_cast<signed char>(10 + i);
+        }
+
+        blanks[' '] = blanks['\t'] = blanks['\n'] = blanks['\v'] = blanks['\f'] = blanks['\r'] = true;
+    }
+};
+
+// built at compile time, safe to use from other static initializers
+constexpr HexTables s_tables;
+
+//! dotted octets, padded or not
+template<bool padded>
+std::size_t encode(
+        const octet* value,
+        std::size_t size,
+        char* out)
+{
+    const HexTables& t = s_tables;
+    char* p = out;
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        const char* digits = t.digits[value[i]];
+
+        if (padded || value[i] > 0xf)
+        {
+            *p++ = digits[0];
+        }
+
+        *p++ = digits[1];
+        *p++ = '.';
+    }
+
+    // overwrite the last dot
+    *--p = '\0';
+    return p - out;
+}
+
+bool decode(
+        const char* text,
+        octet* value,
+        std::size_t size)
+{
+    const HexTables& t = s_tables;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+
+    if (p == nullptr)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (i > 0)
+        {
+            while (t.blanks[*p])
+            {
+                ++p;
+            }
+
+            if (*p++ != '.')
+            {
+                return false;
+            }
+        }
+
+        while (t.blanks[*p])
+        {
+            ++p;
+        }
+
+        const unsigned char* first = p;
+        unsigned int octet_value = 0;
+
+        for (signed char nibble; (nibble = t.nibbles[*p]) >= 0; ++p)
+        {
+            octet_value = (octet_value << 4) | static_cast<unsigned int>(nibble);
+
+            if (octet_value > 0xff)
+            {
+                return false;
+            }
+        }
+
+        if (p == first)
+        {
+            return false;
+        }
+
+        value[i] = static_cast<octet>(octet_value);
+    }
+
+    return true;
+}
+
+} // namespace
+
+std::size_t guid_codec::Encode(
+        const fastdds::rtps::GuidPrefix_t& prefix,
+        char* out)
+{
+    return encode<true>(prefix.value, fastdds::rtps::GuidPrefix_t::size, out);
+}
+
+std::size_t guid_codec::Encode(
+        const fastdds::rtps::EntityId_t& entity,
+        char* out)
+{
+    return encode<false>(entity.value, fastdds::rtps::EntityId_t::size, out);
+}
+
+bool guid_codec::Decode(
+        const char* text,
+        fastdds::rtps::GuidPrefix_t& prefix)
+{
+    fastdds::rtps::GuidPrefix_t res;
+
+    if (decode(text, res.value, fastdds::rtps::GuidPrefix_t::size))
+    {
+        prefix = res;
+        return true;
+    }
+
+    prefix = fastdds::rtps::GuidPrefix_t::unknown();
+    return false;
+}
+
+bool guid_codec::Decode(
+        const char* text,
+        fastdds::rtps::EntityId_t& entity)
+{
+    fastdds::rtps::EntityId_t res;
+
+    if (decode(text, res.value, fastdds::rtps::EntityId_t::size))
+    {
+        entity = res;
+        return true;
+    }
+
+    entity = fastdds::rtps::EntityId_t::unknown();
+    return false;
+}
@@ -0,0 +1,306 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "InternedString.h"
+#include "log/DSLog.h"
+
+using namespace eprosima::discovery_server;
+
+namespace {
+
+//! strings are kept in fixed size chunks that never move, so lookups by id need no lock
+const std::size_t s_chunk_bits = 10;
+const std::size_t s_chunk_size = std::size_t(1) << s_chunk_bits;
+const std::size_t s_max_chunks = std::size_t(1) << 12;
+
+struct Chunk
+{
+    std::array<std::string, s_chunk_size> strings;
+};
+
+class SymbolTable
+{
+public:
+
+    SymbolTable()
+        : slots_(s_initial_slots)
+    {
+        for (auto& chunk : chunks_)
+        {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+
+        // symbol 0 is the empty string, never looked up
+        chunks_[0].store(new Chunk, std::memory_order_release);
+        count_.store(1, std::memory_order_release);
+    }
+
+    ~SymbolTable()
+    {
+        for (auto& chunk : chunks_)
+        {
+            delete chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    //! returns 0 if not interned, never allocates
+    InternedString::symbol_id lookup(
+            const char* s,
+            std::size_t size,
+            uint32_t h) const
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(mutex_);
+        return find(s, size, h);
+    }
+
+    //! lookups of known strings do not allocate
+    InternedString::symbol_id intern(
+            const char* s,
+            std::size_t size)
+    {
+        uint32_t h = hash(s, size);
+
+        InternedString::symbol_id known = lookup(s, size, h);
+        if (known != 0)
+        {
+            return known;
+        }
+
+        std::unique_lock<std::shared_timed_mutex> lock(mutex_);
+
+        // another thread may have interned it meanwhile
+        InternedString::symbol_id found = find(s, size, h);
+        if (found != 0)
+        {
+            return found;
+        }
+
+        std::size_t id = count_.load(std::memory_order_relaxed);
+        std::size_t chunk_index = id >> s_chunk_bits;
+
+        if (chunk_index >= s_max_chunks)
+        {
+            // symbol 0 is the empty string, returning it would alias unrelated names
+            LOG_ERROR("Interned string table is full, cannot intern " << std::string(s, size));
+            throw std::length_error("interned string table is full");
+        }
+
+        Chunk* chunk = chunks_[chunk_index].load(std::memory_order_relaxed);
+        if (chunk == nullptr)
+        {
+            chunk = new Chunk;
+            chunks_[chunk_index].store(chunk, std::memory_order_release);
+        }
+
+        // the only allocation for a new symbol, short strings fit the std::string inline buffer
+        chunk->strings[id & (s_chunk_size - 1)].assign(s, size);
+
+        // keep the load factor below one half
+        if (2 * (id + 1) > slots_.size())
+        {
+            grow();
+        }
+
+        insert(static_cast<InternedString::symbol_id>(id), h);
+        count_.store(id + 1, std::memory_order_release);
+
+        return static_cast<InternedString::symbol_id>(id);
+    }
+
+    const std::string& str(
+            InternedString::symbol_id id) const
+    {
+        // ids are only handed out after the string is stored
+        assert(id < count_.load(std::memory_order_acquire));
+        const Chunk* chunk = chunks_[id >> s_chunk_bits].load(std::memory_order_acquire);
+        return chunk->strings[id & (s_chunk_size - 1)];
+    }
+
+    std::size_t size() const
+    {
+        return count_.load(std::memory_order_acquire);
+    }
+
+    //! FNV-1a
+    static uint32_t hash(
+            const char* s,
+            std::size_t size)
+    {
+        uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+private:
+
+    //! open addressing slot, symbol 0 marks it free
+    struct Slot
+    {
+        InternedString::symbol_id id = 0;
+        uint32_t hash = 0;
+    };
+
+    static const std::size_t s_initial_slots = 1024;
+
+    //! mutex_ must be locked, returns 0 if not there
+    InternedString::symbol_id find(
+            const char* s,
+            std::size_t size,
+            uint32_t h) const
+    {
+        std::size_t mask = slots_.size() - 1;
+
+        for (std::size_t i = h & mask;; i = (i + 1) & mask)
+        {
+            const Slot& slot = slots_[i];
+
+            if (slot.id == 0)
+            {
+                return 0;
+            }
+
+            if (slot.hash == h)
+            {
+                const std::string& candidate = str(slot.id);
+                if (candidate.size() == size && std::memcmp(candidate.data(), s, size) == 0)
+                {
+                    return slot.id;
+                }
+            }
+        }
+    }
+
+    //! mutex_ must be exclusively locked
+    void insert(
+            InternedString::symbol_id id,
+            uint32_t h)
+    {
+        std::size_t mask = slots_.size() - 1;
+        std::size_t i = h & mask;
+
+        while (slots_[i].id != 0)
+        {
+            i = (i + 1) & mask;
+        }
+
+        slots_[i].id = id;
+        slots_[i].hash = h;
+    }
+
+    //! doubles the slots, mutex_ must be exclusively locked
+    void grow()
+    {
+        std::vector<Slot> old(slots_.size() * 2);
+        old.swap(slots_);
+
+        for (const Slot& slot : old)
+        {
+            if (slot.id != 0)
+            {
+                insert(slot.id, slot.hash);
+            }
+        }
+    }
+
+    mutable std::shared_timed_mutex mutex_;
+    std::vector<Slot> slots_; // power of two size
+    std::array<std::atomic<Chunk*>, s_max_chunks> chunks_;
+    std::atomic<std::size_t> count_;
+};
+
+//! the table outlives any static item that may reference it
+SymbolTable& table()
+{
+    static SymbolTable* table = new SymbolTable;
+    return *table;
+}
+
+} // namespace
+
+InternedString::InternedString(
+        const char* s)
+    : id_(s == nullptr ? 0 : intern(s, std::strlen(s)))
+{
+}
+
+InternedString::symbol_id InternedString::intern(
+        const char* s,
+        std::size_t size)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    return table().intern(s, size);
+}
+
+const std::string& InternedString::str() const
+{
+    return table().str(id_);
+}
+
+std::size_t InternedString::symbols()
+{
+    return table().size();
+}
+
+bool InternedString::Find(
+        const std::string& s,
+        InternedString& found)
+{
+    return Find(s.data(), s.size(), found);
+}
+
+bool InternedString::Find(
+        const char* s,
+        std::size_t size,
+        InternedString& found)
+{
+    if (size == 0)
+    {
+        found = InternedString();
+        return true;
+    }
+
+    symbol_id id = table().lookup(s, size, SymbolTable::hash(s, size));
+
+    if (id == 0)
+    {
+        return false;
+    }
+
+    found = InternedString(id);
+    return true;
+}
+
+std::ostream& eprosima::discovery_server::operator <<(
+        std::ostream& os,
+        const InternedString& s)
+{
+    return os << s.str();
+}
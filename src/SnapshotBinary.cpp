@@ -0,0 +1,517 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <unordered_map>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // ifdef _WIN32
+
+#include "DiscoveryArena.h"
+#include "SnapshotBinary.h"
+#include "log/DSLog.h"
+
+using namespace eprosima::discovery_server;
+using namespace eprosima::discovery_server::snapshot_binary;
+
+// the layout must not depend on the compiler padding
+static_assert(sizeof(FileHeader) == 88, "binary snapshot header layout");
+static_assert(sizeof(SnapshotRecord) == 56, "binary snapshot record layout");
+static_assert(sizeof(DatabaseRecord) == 32, "binary snapshot record layout");
+static_assert(sizeof(ItemRecord) == 56, "binary snapshot record layout");
+static_assert(sizeof(EndpointRecord) == 56, "binary snapshot record layout");
+
+namespace {
+
+bool in_range(
+        uint32_t first,
+        uint32_t count,
+        uint32_t total)
+{
+    return first <= total && count <= total - first;
+}
+
+bool fits(
+        uint64_t offset,
+        uint64_t count,
+        uint64_t record_size,
+        uint64_t size)
+{
+    return offset % 8 == 0 && offset <= size && count <= (size - offset) / record_size;
+}
+
+void store_guid(
+        const GUID_t& guid,
+        uint8_t (&dest)[16])
+{
+    std::memcpy(dest, guid.guidPrefix.value, 12);
+    std::memcpy(dest + 12, guid.entityId.value, 4);
+}
+
+int64_t ms(
+        std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+}
+
+//! gathers the records in file order, strings are shared
+class Writer
+{
+public:
+
+    Writer()
+    {
+        // offset 0 is the empty string
+        strings_.push_back('\0');
+        string_refs_.emplace(std::string(), StringRef{0, 0});
+    }
+
+    void add(
+            const Snapshot& sh)
+    {
+        SnapshotRecord rec{};
+        rec.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+            Snapshot::getSystemTime(sh._time).time_since_epoch()).count();
+        rec.process_time = ms(sh._time - sh.process_startup_);
+        rec.last_pdp_callback = ms(sh.last_PDP_callback_ - sh.process_startup_);
+        rec.last_edp_callback = ms(sh.last_EDP_callback_ - sh.process_startup_);
+        rec.description = string(sh._des);
+        rec.someone = sh.if_someone;
+        rec.first_database = static_cast<uint32_t>(databases_.size());
+        rec.database_count = static_cast<uint32_t>(sh.size());
+        snapshots_.push_back(rec);
+
+        for (const ParticipantDiscoveryDatabase& db : sh)
+        {
+            add(sh, db);
+        }
+    }
+
+    bool save(
+            const std::string& file) const
+    {
+        FileHeader header{};
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.version = version;
+        header.byte_order = byte_order_mark;
+        header.snapshot_count = static_cast<uint32_t>(snapshots_.size());
+        header.database_count = static_cast<uint32_t>(databases_.size());
+        header.item_count = static_cast<uint32_t>(items_.size());
+        header.endpoint_count = static_cast<uint32_t>(endpoints_.size());
+        header.snapshots_offset = sizeof(FileHeader);
+        header.databases_offset = header.snapshots_offset + snapshots_.size() * sizeof(SnapshotRecord);
+        header.items_offset = header.databases_offset + databases_.size() * sizeof(DatabaseRecord);
+        header.endpoints_offset = header.items_offset + items_.size() * sizeof(ItemRecord);
+        header.strings_offset = header.endpoints_offset + endpoints_.size() * sizeof(EndpointRecord);
+        header.strings_size = strings_.size();
+        header.file_size = header.strings_offset + strings_.size();
+
+        std::ofstream out(file, std::ios::binary | std::ios::trunc);
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        write(out, snapshots_);
+        write(out, databases_);
+        write(out, items_);
+        write(out, endpoints_);
+        write(out, strings_);
+
+        return static_cast<bool>(out.flush());
+    }
+
+private:
+
+    void add(
+            const Snapshot& sh,
+            const ParticipantDiscoveryDatabase& db)
+    {
+        DatabaseRecord rec{};
+        store_guid(db.endpoint_guid, rec.guid);
+        rec.name = string(db.participant_name_);
+        rec.first_item = static_cast<uint32_t>(items_.size());
+        rec.item_count = static_cast<uint32_t>(db.size());
+        databases_.push_back(rec);
+
+        for (const ParticipantDiscoveryItem& item : db)
+        {
+            ItemRecord irec{};
+            store_guid(item.endpoint_guid, irec.guid);
+            irec.name = string(item.participant_name);
+            irec.discovered_timestamp = ms(item.discovered_timestamp_ - sh.process_startup_);
+            irec.server = item.is_server;
+            irec.alive = item.is_alive;
+
+            irec.first_reader = static_cast<uint32_t>(endpoints_.size());
+            for (const DataReaderDiscoveryItem& sub : item.getDataReaders())
+            {
+                EndpointRecord& erec = endpoint(sh, sub);
+
+                // same criteria as Snapshot::to_xml
+                if (sh.show_liveliness_ && (sub.endpoint_guid.guidPrefix == db.endpoint_guid.guidPrefix))
+                {
+                    erec.liveliness = true;
+                    erec.alive_count = sub.alive_count;
+                    erec.not_alive_count = sub.not_alive_count;
+                }
+            }
+            irec.reader_count = static_cast<uint32_t>(endpoints_.size()) - irec.first_reader;
+
+            irec.first_writer = static_cast<uint32_t>(endpoints_.size());
+            for (const DataWriterDiscoveryItem& pub : item.getDataWriters())
+            {
+                endpoint(sh, pub);
+            }
+            irec.writer_count = static_cast<uint32_t>(endpoints_.size()) - irec.first_writer;
+
+            items_.push_back(irec);
+        }
+    }
+
+    template<class Endpoint>
+    EndpointRecord& endpoint(
+            const Snapshot& sh,
+            const Endpoint& ep)
+    {
+        EndpointRecord rec{};
+        store_guid(ep.endpoint_guid, rec.guid);
+        rec.type = string(ep.type_name.c_str());
+        rec.topic = string(ep.topic_name.c_str());
+        rec.discovered_timestamp = ms(ep.discovered_timestamp_ - sh.process_startup_);
+        endpoints_.push_back(rec);
+        return endpoints_.back();
+    }
+
+    StringRef string(
+            const std::string& s)
+    {
+        auto it = string_refs_.find(s);
+
+        if (it != string_refs_.end())
+        {
+            return it->second;
+        }
+
+        StringRef ref{static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(s.size())};
+        strings_.insert(strings_.end(), s.begin(), s.end());
+        strings_.push_back('\0');
+        string_refs_.emplace(s, ref);
+        return ref;
+    }
+
+    template<class T>
+    static void write(
+            std::ofstream& out,
+            const std::vector<T>& records)
+    {
+        out.write(reinterpret_cast<const char*>(records.data()), records.size() * sizeof(T));
+    }
+
+    std::vector<SnapshotRecord> snapshots_;
+    std::vector<DatabaseRecord> databases_;
+    std::vector<ItemRecord> items_;
+    std::vector<EndpointRecord> endpoints_;
+    std::vector<char> strings_;
+    std::unordered_map<std::string, StringRef> string_refs_;
+};
+
+} // namespace
+
+BinarySnapshotFile::BinarySnapshotFile(
+        const std::string& file)
+{
+#ifdef _WIN32
+    HANDLE h = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                    FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (h == INVALID_HANDLE_VALUE)
+    {
+        LOG_ERROR("Couldn't open the binary snapshot file: " << file);
+        return;
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(h, &size) && size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(h, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr)
+        {
+            data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+            size_ = data_ ? static_cast<std::size_t>(size.QuadPart) : 0;
+            CloseHandle(mapping); // the view keeps the mapping alive
+        }
+    }
+    CloseHandle(h);
+#else
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        LOG_ERROR("Couldn't open the binary snapshot file: " << file);
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED)
+        {
+            data_ = static_cast<const uint8_t*>(addr);
+            size_ = static_cast<std::size_t>(st.st_size);
+        }
+    }
+    close(fd); // the mapping outlives the descriptor
+#endif // ifdef _WIN32
+
+    if (data_ == nullptr)
+    {
+        LOG_ERROR("Couldn't map the binary snapshot file: " << file);
+        return;
+    }
+
+    header_ = reinterpret_cast<const FileHeader*>(data_);
+
+    if (!verify())
+    {
+        header_ = nullptr;
+        LOG_ERROR("Not a valid binary snapshot file: " << file);
+    }
+}
+
+BinarySnapshotFile::~BinarySnapshotFile()
+{
+    if (data_ != nullptr)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        munmap(const_cast<uint8_t*>(data_), size_);
+#endif // ifdef _WIN32
+    }
+}
+
+bool BinarySnapshotFile::verify() const
+{
+    const FileHeader& h = *header_;
+
+    if (size_ < sizeof(FileHeader)
+            || std::memcmp(h.magic, magic, sizeof(magic)) != 0
+            || h.byte_order != byte_order_mark
+            || h.version != version
+            || h.file_size != size_)
+    {
+        return false;
+    }
+
+    if (!fits(h.snapshots_offset, h.snapshot_count, sizeof(SnapshotRecord), size_)
+            || !fits(h.databases_offset, h.database_count, sizeof(DatabaseRecord), size_)
+            || !fits(h.items_offset, h.item_count, sizeof(ItemRecord), size_)
+            || !fits(h.endpoints_offset, h.endpoint_count, sizeof(EndpointRecord), size_)
+            || h.strings_offset > size_ || h.strings_size > size_ - h.strings_offset
+            || h.strings_size == 0 || data_[h.strings_offset + h.strings_size - 1] != '\0')
+    {
+        return false;
+    }
+
+    // the table ends with a NUL, each string must end right at its own one
+    auto valid_string = [this, &h](const StringRef& ref)
+            {
+                return ref.offset < h.strings_size && ref.length < h.strings_size - ref.offset
+                       && data_[h.strings_offset + ref.offset + ref.length] == '\0';
+            };
+
+    for (const SnapshotRecord& sh : RecordRange<SnapshotRecord>(
+                array<SnapshotRecord>(h.snapshots_offset), h.snapshot_count))
+    {
+        if (!valid_string(sh.description)
+                || !in_range(sh.first_database, sh.database_count, h.database_count))
+        {
+            return false;
+        }
+    }
+
+    for (const DatabaseRecord& db : RecordRange<DatabaseRecord>(
+                array<DatabaseRecord>(h.databases_offset), h.database_count))
+    {
+        if (!valid_string(db.name) || !in_range(db.first_item, db.item_count, h.item_count))
+        {
+            return false;
+        }
+    }
+
+    for (const ItemRecord& item : RecordRange<ItemRecord>(array<ItemRecord>(h.items_offset), h.item_count))
+    {
+        if (!valid_string(item.name)
+                || !in_range(item.first_reader, item.reader_count, h.endpoint_count)
+                || !in_range(item.first_writer, item.writer_count, h.endpoint_count))
+        {
+            return false;
+        }
+    }
+
+    for (const EndpointRecord& ep : RecordRange<EndpointRecord>(
+                array<EndpointRecord>(h.endpoints_offset), h.endpoint_count))
+    {
+        if (!valid_string(ep.type) || !valid_string(ep.topic))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+RecordRange<SnapshotRecord> BinarySnapshotFile::Snapshots() const
+{
+    return RecordRange<SnapshotRecord>(array<SnapshotRecord>(header_->snapshots_offset), header_->snapshot_count);
+}
+
+RecordRange<DatabaseRecord> BinarySnapshotFile::Databases(
+        const SnapshotRecord& snapshot) const
+{
+    return RecordRange<DatabaseRecord>(
+        array<DatabaseRecord>(header_->databases_offset) + snapshot.first_database, snapshot.database_count);
+}
+
+RecordRange<ItemRecord> BinarySnapshotFile::Items(
+        const DatabaseRecord& database) const
+{
+    return RecordRange<ItemRecord>(array<ItemRecord>(header_->items_offset) + database.first_item, database.item_count);
+}
+
+RecordRange<EndpointRecord> BinarySnapshotFile::Readers(
+        const ItemRecord& item) const
+{
+    return RecordRange<EndpointRecord>(
+        array<EndpointRecord>(header_->endpoints_offset) + item.first_reader, item.reader_count);
+}
+
+RecordRange<EndpointRecord> BinarySnapshotFile::Writers(
+        const ItemRecord& item) const
+{
+    return RecordRange<EndpointRecord>(
+        array<EndpointRecord>(header_->endpoints_offset) + item.first_writer, item.writer_count);
+}
+
+const char* BinarySnapshotFile::String(
+        const StringRef& ref) const
+{
+    return reinterpret_cast<const char*>(data_ + header_->strings_offset + ref.offset);
+}
+
+GUID_t BinarySnapshotFile::Guid(
+        const uint8_t (&guid)[16])
+{
+    GUID_t res;
+    std::memcpy(res.guidPrefix.value, guid, 12);
+    std::memcpy(res.entityId.value, guid + 12, 4);
+    return res;
+}
+
+Snapshot BinarySnapshotFile::ToSnapshot(
+        const SnapshotRecord& rec) const
+{
+    using std::chrono::milliseconds;
+
+    // nodes go to an arena of the snapshot, released with it, instead of the process default one
+    ArenaScope scope(std::make_shared<DiscoveryArena>());
+    Snapshot sh;
+    sh.restore_times(milliseconds(rec.timestamp), milliseconds(rec.process_time),
+            milliseconds(rec.last_pdp_callback), milliseconds(rec.last_edp_callback));
+    sh.if_someone = rec.someone != 0;
+    sh._des = String(rec.description);
+
+    for (const DatabaseRecord& db : Databases(rec))
+    {
+        ParticipantDiscoveryDatabase discovery_database(Guid(db.guid), String(db.name));
+
+        for (const ItemRecord& item : Items(db))
+        {
+            ParticipantDiscoveryItem discovery_item(Guid(item.guid), String(item.name), item.server != 0,
+                    sh.process_startup_ + milliseconds(item.discovered_timestamp));
+            discovery_item.is_alive = item.alive != 0;
+
+            // records are sorted as the sets, so each insertion goes last
+            ParticipantDiscoveryItem::subscriber_set& subs =
+                    discovery_item.getDataReaders(discovery_database.generation());
+
+            for (const EndpointRecord& ep : Readers(item))
+            {
+                DataReaderDiscoveryItem sub(Guid(ep.guid), String(ep.type), String(ep.topic),
+                        sh.process_startup_ + milliseconds(ep.discovered_timestamp));
+
+                if (ep.liveliness)
+                {
+                    sub.alive_count = ep.alive_count;
+                    sub.not_alive_count = ep.not_alive_count;
+                    sh.show_liveliness_ = true;
+                }
+
+                subs.insert(subs.end(), std::move(sub));
+            }
+
+            ParticipantDiscoveryItem::publisher_set& pubs =
+                    discovery_item.getDataWriters(discovery_database.generation());
+
+            for (const EndpointRecord& ep : Writers(item))
+            {
+                pubs.insert(pubs.end(), DataWriterDiscoveryItem(Guid(ep.guid), String(ep.type), String(ep.topic),
+                        sh.process_startup_ + milliseconds(ep.discovered_timestamp)));
+            }
+
+            discovery_database.insert(std::move(discovery_item));
+        }
+
+        sh.insert(sh.end(), std::move(discovery_database));
+    }
+
+    return sh;
+}
+
+bool BinarySnapshotFile::Probe(
+        const std::string& file)
+{
+    char head[sizeof(magic)] = {};
+    std::ifstream in(file, std::ios::binary);
+    in.read(head, sizeof(head));
+
+    return in && std::memcmp(head, magic, sizeof(magic)) == 0;
+}
+
+bool eprosima::discovery_server::SaveBinarySnapshots(
+        const std::string& file,
+        const std::vector<Snapshot>& snapshots)
+{
+    Writer writer;
+
+    for (const Snapshot& sh : snapshots)
+    {
+        writer.add(sh);
+    }
+
+    return writer.save(file);
+}
+
+bool eprosima::discovery_server::HasBinarySnapshotExtension(
+        const std::string& file)
+{
+    const std::size_t len = sizeof(extension) - 1;
+
+    return file.size() >= len && file.compare(file.size() - len, len, extension) == 0;
+}
@@ -0,0 +1,1176 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+
+#include "DiscoveryArena.h"
+#include "GuidCodec.h"
+#include "IDs.h"
+#include "SnapshotXmlReader.h"
+
+using namespace eprosima::discovery_server;
+
+namespace {
+
+struct Attribute
+{
+    std::string name;
+    std::string value;
+};
+
+//! attributes of the element being opened, the strings keep their capacity among elements
+class Attributes
+{
+public:
+
+    void clear()
+    {
+        size_ = 0;
+    }
+
+    Attribute& add()
+    {
+        if (size_ == list_.size())
+        {
+            list_.emplace_back();
+        }
+
+        Attribute& attribute = list_[size_++];
+        attribute.name.clear();
+        attribute.value.clear();
+        return attribute;
+    }
+
+    //! null if not there
+    const char* find(
+            const std::string& name) const
+    {
+        for (std::size_t i = 0; i < size_; ++i)
+        {
+            if (list_[i].name == name)
+            {
+                return list_[i].value.c_str();
+            }
+        }
+
+        return nullptr;
+    }
+
+private:
+
+    std::vector<Attribute> list_;
+    std::size_t size_ = 0;
+};
+
+//! parser events
+class SaxHandler
+{
+public:
+
+    virtual ~SaxHandler() = default;
+
+    //! returning false skips the element content, neither it nor the element end are reported
+    virtual bool start_element(
+            const std::string& name,
+            const Attributes& attributes) = 0;
+
+    virtual void end_element() = 0;
+
+    //! element text, may be reported in several chunks
+    virtual void text(
+            const std::string& text) = 0;
+
+    //! stops the parsing
+    virtual bool finished() const
+    {
+        return false;
+    }
+};
+
+/**
+ * Minimal streaming XML parser. It reads elements, attributes, text, CDATA sections and the
+ * predefined and numeric entities, and skips declarations, comments and DTDs.
+ **/
+class SaxParser
+{
+public:
+
+    SaxParser(
+            std::istream& in,
+            SaxHandler& handler)
+        : in_(*in.rdbuf())
+        , handler_(handler)
+    {
+    }
+
+    bool parse(
+            std::string& error);
+
+private:
+
+    typedef std::char_traits<char> traits;
+
+    int get()
+    {
+        int c = in_.sbumpc();
+        line_ += (c == '\n');
+        return c;
+    }
+
+    int peek()
+    {
+        return in_.sgetc();
+    }
+
+    bool skipping() const
+    {
+        return skip_level_ != 0;
+    }
+
+    bool fail(
+            const char* what)
+    {
+        std::ostringstream o;
+        o << what << " at line " << line_;
+        error_ = o.str();
+        return false;
+    }
+
+    static bool is_space(
+            int c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool is_name(
+            int c)
+    {
+        return c != traits::eof() && !is_space(c) && c != '/' && c != '>' && c != '=' && c != '<';
+    }
+
+    void skip_spaces()
+    {
+        while (is_space(peek()))
+        {
+            get();
+        }
+    }
+
+    //! consumes the input up to and including the terminator, appending it to out if any
+    bool read_until(
+            const char* terminator,
+            std::string* out);
+
+    bool read_name(
+            std::string& name);
+
+    //! decodes the entity after an &, appending it to out if any
+    bool read_entity(
+            std::string* out);
+
+    bool markup();
+    bool element();
+    bool end_tag();
+    void flush_text();
+
+    std::streambuf& in_;
+    SaxHandler& handler_;
+    std::vector<std::string> stack_; // names of the open elements, reused
+    std::size_t depth_ = 0;
+    std::size_t skip_level_ = 0; // depth of the skipped element, 0 if not skipping
+    Attributes attributes_;
+    std::string name_;
+    std::string text_;
+    std::string error_;
+    unsigned line_ = 1;
+};
+
+bool SaxParser::parse(
+        std::string& error)
+{
+    bool ok = true;
+
+    for (int c = get(); ok && !handler_.finished() && c != traits::eof(); c = get())
+    {
+        if (c == '<')
+        {
+            flush_text();
+            ok = markup();
+        }
+        else if (depth_ == 0)
+        {
+            // only blanks outside the root element
+        }
+        else if (c == '&')
+        {
+            ok = read_entity(skipping() ? nullptr : &text_);
+        }
+        else if (!skipping())
+        {
+            text_ += static_cast<char>(c);
+        }
+    }
+
+    if (ok && depth_ != 0 && !handler_.finished())
+    {
+        ok = fail("Unexpected end of file");
+    }
+
+    error = error_;
+    return ok;
+}
+
+void SaxParser::flush_text()
+{
+    if (!text_.empty())
+    {
+        handler_.text(text_);
+        text_.clear();
+    }
+}
+
+bool SaxParser::markup()
+{
+    int c = peek();
+
+    if (c == '?')
+    {
+        return read_until("?>", nullptr);
+    }
+
+    if (c == '!')
+    {
+        get();
+
+        if (peek() == '-')
+        {
+            return read_until("-->", nullptr);
+        }
+
+        if (peek() == '[')
+        {
+            // CDATA is text kept verbatim
+            return read_until("[CDATA[", nullptr) && read_until("]]>", skipping() ? nullptr : &text_);
+        }
+
+        return read_until(">", nullptr);
+    }
+
+    if (c == '/')
+    {
+        get();
+        return end_tag();
+    }
+
+    return element();
+}
+
+bool SaxParser::read_until(
+        const char* terminator,
+        std::string* out)
+{
+    const std::size_t len = std::strlen(terminator);
+    std::string window;
+
+    for (int c = get(); c != traits::eof(); c = get())
+    {
+        window += static_cast<char>(c);
+
+        if (window.size() > len)
+        {
+            if (out != nullptr)
+            {
+                *out += window.front();
+            }
+
+            window.erase(0, 1);
+        }
+
+        if (window == terminator)
+        {
+            return true;
+        }
+    }
+
+    return fail("Unterminated markup");
+}
+
+bool SaxParser::read_name(
+        std::string& name)
+{
+    name.clear();
+
+    while (is_name(peek()))
+    {
+        name += static_cast<char>(get());
+    }
+
+    return !name.empty() || fail("Expected a name");
+}
+
+bool SaxParser::read_entity(
+        std::string* out)
+{
+    char entity[12];
+    std::size_t len = 0;
+
+    for (int c = get(); c != ';'; c = get())
+    {
+        if (c == traits::eof() || len == sizeof(entity) - 1)
+        {
+            return fail("Unterminated entity");
+        }
+
+        entity[len++] = static_cast<char>(c);
+    }
+
+    entity[len] = '\0';
+
+    if (out == nullptr)
+    {
+        return true;
+    }
+
+    static const struct
+    {
+        const char* name;
+        char value;
+    } predefined[] = {{"lt", '<'}, {"gt", '>'}, {"amp", '&'}, {"quot", '"'}, {"apos", '\''}};
+
+    for (const auto& p : predefined)
+    {
+        if (std::strcmp(entity, p.name) == 0)
+        {
+            *out += p.value;
+            return true;
+        }
+    }
+
+    if (entity[0] == '#')
+    {
+        // numeric reference to UTF-8
+        char* end = nullptr;
+        unsigned long cp = entity[1] == 'x' ? std::strtoul(entity + 2, &end, 16) : std::strtoul(entity + 1, &end, 10);
+
+        if (end != nullptr && *end == '\0' && cp <= 0x10FFFF)
+        {
+            if (cp < 0x80)
+            {
+                *out += static_cast<char>(cp);
+            }
+            else if (cp < 0x800)
+            {
+                *out += static_cast<char>(0xC0 | (cp >> 6));
+                *out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            else if (cp < 0x10000)
+            {
+                *out += static_cast<char>(0xE0 | (cp >> 12));
+                *out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                *out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+            else
+            {
+                *out += static_cast<char>(0xF0 | (cp >> 18));
+                *out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                *out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                *out += static_cast<char>(0x80 | (cp & 0x3F));
+            }
+
+            return true;
+        }
+    }
+
+    // unknown entities are kept verbatim as tinyxml2 does
+    *out += '&';
+    *out += entity;
+    *out += ';';
+    return true;
+}
+
+bool SaxParser::element()
+{
+    if (stack_.size() == depth_)
+    {
+        stack_.emplace_back();
+    }
+
+    std::string& name = stack_[depth_];
+
+    if (!read_name(name))
+    {
+        return false;
+    }
+
+    // attribute values are only kept if the element is reported
+    const bool report = !skipping();
+    attributes_.clear();
+    bool closed = false;
+
+    for (;;)
+    {
+        skip_spaces();
+        int c = get();
+
+        if (c == '>')
+        {
+            break;
+        }
+
+        if (c == '/')
+        {
+            if (get() != '>')
+            {
+                return fail("Expected >");
+            }
+
+            closed = true;
+            break;
+        }
+
+        if (!is_name(c))
+        {
+            return fail("Malformed element");
+        }
+
+        Attribute* attribute = report ? &attributes_.add() : nullptr;
+        std::string& attribute_name = report ? attribute->name : name_;
+        attribute_name.assign(1, static_cast<char>(c));
+
+        while (is_name(peek()))
+        {
+            attribute_name += static_cast<char>(get());
+        }
+
+        skip_spaces();
+
+        if (get() != '=')
+        {
+            return fail("Expected =");
+        }
+
+        skip_spaces();
+        int quote = get();
+
+        if (quote != '"' && quote != '\'')
+        {
+            return fail("Expected a quoted attribute value");
+        }
+
+        for (c = get(); c != quote; c = get())
+        {
+            if (c == traits::eof())
+            {
+                return fail("Unterminated attribute value");
+            }
+            else if (c == '&')
+            {
+                if (!read_entity(report ? &attribute->value : nullptr))
+                {
+                    return false;
+                }
+            }
+            else if (report)
+            {
+                attribute->value += static_cast<char>(c);
+            }
+        }
+    }
+
+    bool descend = true;
+
+    if (report)
+    {
+        descend = handler_.start_element(name, attributes_);
+
+        if (closed && descend)
+        {
+            handler_.end_element();
+        }
+    }
+
+    if (!closed)
+    {
+        ++depth_;
+
+        if (!descend)
+        {
+            skip_level_ = depth_;
+        }
+    }
+
+    return true;
+}
+
+bool SaxParser::end_tag()
+{
+    if (!read_name(name_))
+    {
+        return false;
+    }
+
+    skip_spaces();
+
+    if (get() != '>')
+    {
+        return fail("Expected >");
+    }
+
+    if (depth_ == 0 || stack_[depth_ - 1] != name_)
+    {
+        return fail("Mismatched end tag");
+    }
+
+    if (skip_level_ == depth_)
+    {
+        skip_level_ = 0; // the skipped element end is not reported
+    }
+    else if (!skipping())
+    {
+        handler_.end_element();
+    }
+
+    --depth_;
+    return true;
+}
+
+int64_t int64_attribute(
+        const Attributes& attributes,
+        const std::string& name,
+        int64_t default_value = 0)
+{
+    const char* value = attributes.find(name);
+    char* end = nullptr;
+
+    if (value != nullptr)
+    {
+        long long res = std::strtoll(value, &end, 10);
+
+        if (end != value)
+        {
+            return res;
+        }
+    }
+
+    return default_value;
+}
+
+//! tinyxml2 rules, numbers or true/false in any of its usual casings
+bool query_bool_attribute(
+        const Attributes& attributes,
+        const std::string& name,
+        bool& res)
+{
+    const char* value = attributes.find(name);
+
+    if (value == nullptr)
+    {
+        return false;
+    }
+
+    char* end = nullptr;
+    long number = std::strtol(value, &end, 10);
+
+    if (end != value)
+    {
+        res = number != 0;
+        return true;
+    }
+
+    for (const char* t : {"true", "True", "TRUE"})
+    {
+        if (std::strcmp(value, t) == 0)
+        {
+            res = true;
+            return true;
+        }
+    }
+
+    for (const char* f : {"false", "False", "FALSE"})
+    {
+        if (std::strcmp(value, f) == 0)
+        {
+            res = false;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool bool_attribute(
+        const Attributes& attributes,
+        const std::string& name,
+        bool default_value)
+{
+    query_bool_attribute(attributes, name, default_value);
+    return default_value;
+}
+
+bool query_int_attribute(
+        const Attributes& attributes,
+        const std::string& name,
+        int32_t& res)
+{
+    const char* value = attributes.find(name);
+    char* end = nullptr;
+
+    if (value != nullptr)
+    {
+        long number = std::strtol(value, &end, 10);
+
+        if (end != value)
+        {
+            res = static_cast<int32_t>(number);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+const char* string_attribute(
+        const Attributes& attributes,
+        const std::string& name)
+{
+    const char* value = attributes.find(name);
+    return value ? value : "";
+}
+
+//! builds the snapshots from the parser events, mirrors Snapshot::from_xml
+class SnapshotBuilder : public SaxHandler
+{
+public:
+
+    SnapshotBuilder(
+            const SnapshotFilter& filter,
+            std::vector<Snapshot>& snapshots)
+        : filter_(filter)
+        , snapshots_(snapshots)
+    {
+    }
+
+    bool start_element(
+            const std::string& name,
+            const Attributes& attributes) override;
+
+    void end_element() override;
+
+    void text(
+            const std::string& text) override
+    {
+        if (level_ == Level::DESCRIPTION)
+        {
+            description_ += text;
+        }
+    }
+
+    bool root_found = false;
+    std::size_t skipped = 0;
+
+private:
+
+    enum class Level
+    {
+        DOCUMENT,
+        ROOT,
+        SNAPSHOT,
+        DESCRIPTION,
+        TABLE,
+        ROW,
+        ROW_ENDPOINT,
+        DATABASE,
+        ITEM,
+        ENDPOINT
+    };
+
+    //! normalized encoding participants table entries
+    struct ParticipantRow
+    {
+        GUID_t guid;
+        std::string name;
+        bool server;
+        bool alive;
+    };
+
+    struct EndpointRow
+    {
+        GUID_t guid;
+        InternedString type;
+        InternedString topic;
+        bool reader;
+    };
+
+    GUID_t guid(
+            const Attributes& attributes) const;
+
+    bool add_item(
+            ParticipantDiscoveryItem&& item);
+
+    void add_reader(
+            DataReaderDiscoveryItem&& sub,
+            const Attributes& attributes);
+
+    void add_writer(
+            DataWriterDiscoveryItem&& pub);
+
+    //! overridden value or the row one
+    static InternedString string_or(
+            const Attributes& attributes,
+            const std::string& name,
+            const InternedString& row_value)
+    {
+        const char* value = attributes.find(name);
+        return value ? InternedString(value) : row_value;
+    }
+
+    std::chrono::steady_clock::time_point discovered(
+            const Attributes& attributes) const
+    {
+        return snapshot_.process_startup_ +
+               std::chrono::milliseconds(int64_attribute(attributes, s_sDiscovered_timestamp));
+    }
+
+    //! the description precedes the databases as the schema sequence requires
+    void decide();
+
+    const SnapshotFilter& filter_;
+    std::vector<Snapshot>& snapshots_;
+
+    Level level_ = Level::DOCUMENT;
+    Snapshot snapshot_;
+    std::string description_;
+    bool decided_ = false;
+    bool selected_ = false;
+    std::unique_ptr<ParticipantDiscoveryDatabase> database_;
+    ParticipantDiscoveryDatabase::const_iterator item_;
+    std::unordered_map<int64_t, ParticipantRow> participant_rows_;
+    std::unordered_map<int64_t, EndpointRow> endpoint_rows_;
+    eprosima::fastdds::rtps::GuidPrefix_t row_prefix_; // of the participant row being read
+};
+
+GUID_t SnapshotBuilder::guid(
+        const Attributes& attributes) const
+{
+    GUID_t res;
+    guid_codec::Decode(string_attribute(attributes, s_sGUID_prefix), res.guidPrefix);
+    guid_codec::Decode(string_attribute(attributes, s_sGUID_entity), res.entityId);
+    return res;
+}
+
+bool SnapshotBuilder::add_item(
+        ParticipantDiscoveryItem&& item)
+{
+    auto res = database_->insert(std::move(item));
+
+    if (!res.second)
+    {
+        return false; // repeated, ignored like its endpoints
+    }
+
+    item_ = res.first;
+    level_ = Level::ITEM;
+    return true;
+}
+
+void SnapshotBuilder::add_reader(
+        DataReaderDiscoveryItem&& sub,
+        const Attributes& attributes)
+{
+    // liveliness values if any
+    bool alive = query_int_attribute(attributes, s_sAliveCount, sub.alive_count);
+    bool not_alive = query_int_attribute(attributes, s_sNotAliveCount, sub.not_alive_count);
+    snapshot_.show_liveliness_ |= alive || not_alive;
+
+    // endpoints added through the database keep its counters
+    uint64_t generation = database_->generation();
+    database_->modify(item_, [&](const ParticipantDiscoveryItem& item)
+            {
+                item.getDataReaders(generation).insert(std::move(sub));
+            });
+
+    level_ = Level::ENDPOINT;
+}
+
+void SnapshotBuilder::add_writer(
+        DataWriterDiscoveryItem&& pub)
+{
+    uint64_t generation = database_->generation();
+    database_->modify(item_, [&](const ParticipantDiscoveryItem& item)
+            {
+                item.getDataWriters(generation).insert(std::move(pub));
+            });
+
+    level_ = Level::ENDPOINT;
+}
+
+void SnapshotBuilder::decide()
+{
+    if (decided_)
+    {
+        return;
+    }
+
+    // blank text is not kept as a text node
+    if (description_.find_first_not_of(" \t\r\n") == std::string::npos)
+    {
+        description_.clear();
+    }
+
+    snapshot_._des = description_;
+    selected_ = !filter_ || filter_(description_);
+    decided_ = true;
+}
+
+bool SnapshotBuilder::start_element(
+        const std::string& name,
+        const Attributes& attributes)
+{
+    switch (level_)
+    {
+        case Level::DOCUMENT:
+            if (name != s_sDS_Snapshots)
+            {
+                return false;
+            }
+
+            root_found = true;
+            level_ = Level::ROOT;
+            return true;
+
+        case Level::ROOT:
+            if (name != s_sDS_Snapshot)
+            {
+                return false;
+            }
+
+            snapshot_ = Snapshot();
+            snapshot_.restore_times(
+                std::chrono::milliseconds(int64_attribute(attributes, s_sTimestamp)),
+                std::chrono::milliseconds(int64_attribute(attributes, s_sProcessTime)),
+                std::chrono::milliseconds(int64_attribute(attributes, s_sLastPdpCallback)),
+                std::chrono::milliseconds(int64_attribute(attributes, s_sLastEdpCallback)));
+            snapshot_.if_someone = bool_attribute(attributes, s_sSomeone, true);
+            description_.clear();
+            decided_ = false;
+            participant_rows_.clear();
+            endpoint_rows_.clear();
+            level_ = Level::SNAPSHOT;
+            return true;
+
+        case Level::SNAPSHOT:
+            if (name == s_sDescription)
+            {
+                level_ = Level::DESCRIPTION;
+                return true;
+            }
+
+            if (name == s_sParticipants)
+            {
+                decide();
+
+                if (!selected_)
+                {
+                    return false;
+                }
+
+                level_ = Level::TABLE;
+                return true;
+            }
+
+            if (name != s_sPtDB)
+            {
+                return false;
+            }
+
+            decide();
+
+            if (!selected_)
+            {
+                return false; // the database is scanned but not built
+            }
+
+            database_.reset(new ParticipantDiscoveryDatabase(guid(attributes), string_attribute(attributes, s_sName)));
+            level_ = Level::DATABASE;
+            return true;
+
+        case Level::TABLE:
+        {
+            if (name != s_sParticipant || attributes.find(s_sId) == nullptr)
+            {
+                return false;
+            }
+
+            ParticipantRow row{guid(attributes), string_attribute(attributes, s_sName),
+                               bool_attribute(attributes, s_sServer, false),
+                               bool_attribute(attributes, s_sAlive, true)};
+            row_prefix_ = row.guid.guidPrefix;
+            participant_rows_[int64_attribute(attributes, s_sId)] = std::move(row);
+            level_ = Level::ROW;
+            return true;
+        }
+
+        case Level::ROW:
+        {
+            bool reader = name == s_sSubscriber;
+
+            if ((!reader && name != s_sPublisher) || attributes.find(s_sId) == nullptr)
+            {
+                return false;
+            }
+
+            // the participant provides the prefix unless given
+            EndpointRow row{guid(attributes), string_attribute(attributes, s_sType),
+                            string_attribute(attributes, s_sTopic), reader};
+
+            if (attributes.find(s_sGUID_prefix) == nullptr)
+            {
+                row.guid.guidPrefix = row_prefix_;
+            }
+
+            endpoint_rows_[int64_attribute(attributes, s_sId)] = std::move(row);
+            level_ = Level::ROW_ENDPOINT;
+            return true;
+        }
+
+        case Level::DATABASE:
+        {
+            if (name == s_sParticipantRef)
+            {
+                auto row = participant_rows_.find(int64_attribute(attributes, s_sId, -1));
+
+                if (row == participant_rows_.end())
+                {
+                    return false;
+                }
+
+                const char* item_name = attributes.find(s_sName);
+                ParticipantDiscoveryItem item(row->second.guid, item_name ? item_name : row->second.name,
+                        bool_attribute(attributes, s_sServer, row->second.server), discovered(attributes));
+                item.is_alive = bool_attribute(attributes, s_sAlive, row->second.alive);
+
+                return add_item(std::move(item));
+            }
+
+            if (name != s_sPtDI)
+            {
+                return false;
+            }
+
+            ParticipantDiscoveryItem item(guid(attributes), string_attribute(attributes, s_sName),
+                    bool_attribute(attributes, s_sServer, false), discovered(attributes));
+            query_bool_attribute(attributes, s_sAlive, item.is_alive);
+
+            return add_item(std::move(item));
+        }
+
+        case Level::ITEM:
+            if (name == s_sSubscriber)
+            {
+                add_reader(DataReaderDiscoveryItem(guid(attributes), string_attribute(attributes, s_sType),
+                        string_attribute(attributes, s_sTopic), discovered(attributes)), attributes);
+            }
+            else if (name == s_sPublisher)
+            {
+                add_writer(DataWriterDiscoveryItem(guid(attributes), string_attribute(attributes, s_sType),
+                        string_attribute(attributes, s_sTopic), discovered(attributes)));
+            }
+            else if (name == s_sSubscriberRef || name == s_sPublisherRef)
+            {
+                bool reader = name == s_sSubscriberRef;
+                auto row = endpoint_rows_.find(int64_attribute(attributes, s_sId, -1));
+
+                if (row == endpoint_rows_.end() || row->second.reader != reader)
+                {
+                    return false;
+                }
+
+                InternedString type = string_or(attributes, s_sType, row->second.type);
+                InternedString topic = string_or(attributes, s_sTopic, row->second.topic);
+
+                if (reader)
+                {
+                    add_reader(DataReaderDiscoveryItem(row->second.guid, type, topic, discovered(attributes)),
+                            attributes);
+                }
+                else
+                {
+                    add_writer(DataWriterDiscoveryItem(row->second.guid, type, topic, discovered(attributes)));
+                }
+            }
+            else
+            {
+                return false;
+            }
+
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void SnapshotBuilder::end_element()
+{
+    switch (level_)
+    {
+        case Level::ROOT:
+            level_ = Level::DOCUMENT;
+            break;
+
+        case Level::SNAPSHOT:
+            decide();
+
+            if (selected_)
+            {
+                snapshots_.push_back(std::move(snapshot_));
+            }
+            else
+            {
+                ++skipped;
+            }
+
+            level_ = Level::ROOT;
+            break;
+
+        case Level::DESCRIPTION:
+            decide();
+            level_ = Level::SNAPSHOT;
+            break;
+
+        case Level::TABLE:
+            level_ = Level::SNAPSHOT;
+            break;
+
+        case Level::ROW:
+            level_ = Level::TABLE;
+            break;
+
+        case Level::ROW_ENDPOINT:
+            level_ = Level::ROW;
+            break;
+
+        case Level::DATABASE:
+            snapshot_.insert(std::move(*database_));
+            database_.reset();
+            level_ = Level::SNAPSHOT;
+            break;
+
+        case Level::ITEM:
+            level_ = Level::DATABASE;
+            break;
+
+        case Level::ENDPOINT:
+            level_ = Level::ITEM;
+            break;
+
+        default:
+            break;
+    }
+}
+
+//! reads up to the root element start
+class RootProbe : public SaxHandler
+{
+public:
+
+    bool start_element(
+            const std::string& name,
+            const Attributes&) override
+    {
+        root = name;
+        return false;
+    }
+
+    void end_element() override
+    {
+    }
+
+    void text(
+            const std::string&) override
+    {
+    }
+
+    bool finished() const override
+    {
+        return !root.empty();
+    }
+
+    std::string root;
+};
+
+} // namespace
+
+SnapshotXmlReader::SnapshotXmlReader(
+        SnapshotFilter filter)
+    : filter_(std::move(filter))
+{
+}
+
+bool SnapshotXmlReader::Load(
+        std::istream& in,
+        std::vector<Snapshot>& snapshots)
+{
+    // nodes go to an arena of the loaded snapshots, released with the last of them, instead of the process
+    // default one
+    ArenaScope scope(std::make_shared<DiscoveryArena>());
+    SnapshotBuilder builder(filter_, snapshots);
+    SaxParser parser(in, builder);
+
+    if (!parser.parse(error_))
+    {
+        return false;
+    }
+
+    skipped_ = builder.skipped;
+
+    if (!builder.root_found)
+    {
+        error_ = "Not a valid Snapshot file wrong root element";
+        return false;
+    }
+
+    return true;
+}
+
+bool SnapshotXmlReader::Load(
+        const std::string& file,
+        std::vector<Snapshot>& snapshots)
+{
+    std::ifstream in(file, std::ios::binary);
+
+    if (!in)
+    {
+        error_ = "Couldn't open the file";
+        return false;
+    }
+
+    return Load(in, snapshots);
+}
+
+bool SnapshotXmlReader::Probe(
+        const std::string& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    RootProbe probe;
+    SaxParser parser(in, probe);
+    std::string error;
+
+    return in && parser.parse(error) && probe.root == s_sDS_Snapshots;
+}
@@ -0,0 +1,502 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fstream>
+
+#include "GuidCodec.h"
+#include "IDs.h"
+#include "SnapshotXmlWriter.h"
+#include "log/DSLog.h"
+
+using namespace eprosima::discovery_server;
+
+namespace {
+
+int64_t ms(
+        std::chrono::steady_clock::duration d)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+}
+
+//! output buffer, kept constant whatever the snapshots size
+const std::size_t s_buffer_size = 1 << 16;
+
+} // namespace
+
+SnapshotXmlWriter::SnapshotXmlWriter(
+        std::ostream& out,
+        bool normalized)
+    : out_(out)
+    , normalized_(normalized)
+{
+}
+
+void SnapshotXmlWriter::Begin()
+{
+    // default tinyxml2 declaration
+    out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>";
+    first_ = false;
+
+    open(s_sDS_Snapshots);
+    attribute("xmlns", "http://www.eprosima.com/XMLSchemas/ds-snapshot");
+}
+
+void SnapshotXmlWriter::End()
+{
+    close();
+}
+
+void SnapshotXmlWriter::Write(
+        const Snapshot& sh)
+{
+    // same elements and attributes order as Snapshot::to_xml
+    open(s_sDS_Snapshot);
+    attribute(s_sTimestamp, ms(Snapshot::getSystemTime(sh._time).time_since_epoch()));
+    attribute(s_sProcessTime, ms(sh._time - sh.process_startup_));
+    attribute(s_sLastPdpCallback, ms(sh.last_PDP_callback_ - sh.process_startup_));
+    attribute(s_sLastEdpCallback, ms(sh.last_EDP_callback_ - sh.process_startup_));
+    attribute(s_sSomeone, sh.if_someone);
+
+    open(s_sDescription);
+    text(sh._des.c_str());
+    close();
+
+    if (normalized_)
+    {
+        write_table(sh);
+    }
+
+    for (const ParticipantDiscoveryDatabase& discovery_database : sh)
+    {
+        open(s_sPtDB);
+        attribute_id(s_sGUID_prefix, discovery_database.endpoint_guid.guidPrefix);
+        attribute_id(s_sGUID_entity, discovery_database.endpoint_guid.entityId);
+        attribute(s_sName, discovery_database.participant_name_.c_str());
+
+        if (normalized_)
+        {
+            write_references(sh, discovery_database);
+            close();
+            continue;
+        }
+
+        for (const ParticipantDiscoveryItem& discovery_item : discovery_database)
+        {
+            open(s_sPtDI);
+            attribute_id(s_sGUID_prefix, discovery_item.endpoint_guid.guidPrefix);
+            attribute_id(s_sGUID_entity, discovery_item.endpoint_guid.entityId);
+            attribute(s_sServer, discovery_item.is_server);
+            attribute(s_sAlive, discovery_item.is_alive);
+            attribute(s_sName, discovery_item.participant_name.c_str());
+            attribute(s_sDiscovered_timestamp, ms(discovery_item.discovered_timestamp_ - sh.process_startup_));
+
+            for (const DataReaderDiscoveryItem& sub : discovery_item.getDataReaders())
+            {
+                open(s_sSubscriber);
+                attribute(s_sType, sub.type_name.c_str());
+                attribute(s_sTopic, sub.topic_name.c_str());
+                attribute_id(s_sGUID_prefix, sub.endpoint_guid.guidPrefix);
+                attribute_id(s_sGUID_entity, sub.endpoint_guid.entityId);
+                attribute(s_sDiscovered_timestamp, ms(sub.discovered_timestamp_ - sh.process_startup_));
+
+                // liveliness only makes sense on this participant endpoints
+                if (sh.show_liveliness_ &&
+                        (sub.endpoint_guid.guidPrefix == discovery_database.endpoint_guid.guidPrefix))
+                {
+                    attribute(s_sAliveCount, static_cast<int64_t>(sub.alive_count));
+                    attribute(s_sNotAliveCount, static_cast<int64_t>(sub.not_alive_count));
+                }
+
+                close();
+            }
+
+            for (const DataWriterDiscoveryItem& pub : discovery_item.getDataWriters())
+            {
+                open(s_sPublisher);
+                attribute(s_sType, pub.type_name.c_str());
+                attribute(s_sTopic, pub.topic_name.c_str());
+                attribute_id(s_sGUID_prefix, pub.endpoint_guid.guidPrefix);
+                attribute_id(s_sGUID_entity, pub.endpoint_guid.entityId);
+                attribute(s_sDiscovered_timestamp, ms(pub.discovered_timestamp_ - sh.process_startup_));
+                close();
+            }
+
+            close();
+        }
+
+        close();
+    }
+
+    close();
+}
+
+void SnapshotXmlWriter::write_table(
+        const Snapshot& sh)
+{
+    participants_.clear();
+    endpoints_.clear();
+    participant_rows_.clear();
+    endpoint_rows_.clear();
+
+    // rows in the order the participants and endpoints are first found
+    for (const ParticipantDiscoveryDatabase& discovery_database : sh)
+    {
+        for (const ParticipantDiscoveryItem& discovery_item : discovery_database)
+        {
+            auto res = participant_rows_.emplace(discovery_item.endpoint_guid, participants_.size());
+
+            if (res.second)
+            {
+                participants_.push_back({&discovery_item, {}});
+            }
+
+            for (const DataReaderDiscoveryItem& sub : discovery_item.getDataReaders())
+            {
+                add_endpoint(res.first->second, sub.endpoint_guid, sub.type_name, sub.topic_name, true);
+            }
+
+            for (const DataWriterDiscoveryItem& pub : discovery_item.getDataWriters())
+            {
+                add_endpoint(res.first->second, pub.endpoint_guid, pub.type_name, pub.topic_name, false);
+            }
+        }
+    }
+
+    if (participants_.empty())
+    {
+        return;
+    }
+
+    open(s_sParticipants);
+    int64_t endpoint_id = 0;
+
+    for (std::size_t id = 0; id < participants_.size(); ++id)
+    {
+        const ParticipantRow& row = participants_[id];
+        const ParticipantDiscoveryItem& discovery_item = *row.item;
+
+        open(s_sParticipant);
+        attribute(s_sId, static_cast<int64_t>(id));
+        attribute_id(s_sGUID_prefix, discovery_item.endpoint_guid.guidPrefix);
+        attribute_id(s_sGUID_entity, discovery_item.endpoint_guid.entityId);
+        attribute(s_sServer, discovery_item.is_server);
+        attribute(s_sAlive, discovery_item.is_alive);
+        attribute(s_sName, discovery_item.participant_name.c_str());
+
+        // endpoints are nested in the participant, which provides their prefix
+        for (std::size_t index : row.endpoints)
+        {
+            EndpointRow& endpoint = endpoints_[index];
+            endpoint.id = endpoint_id++;
+
+            open(endpoint.reader ? s_sSubscriber : s_sPublisher);
+            attribute(s_sId, endpoint.id);
+
+            if (endpoint.guid.guidPrefix != discovery_item.endpoint_guid.guidPrefix)
+            {
+                attribute_id(s_sGUID_prefix, endpoint.guid.guidPrefix);
+            }
+
+            attribute_id(s_sGUID_entity, endpoint.guid.entityId);
+            attribute(s_sType, endpoint.type.c_str());
+            attribute(s_sTopic, endpoint.topic.c_str());
+            close();
+        }
+
+        close();
+    }
+
+    close();
+}
+
+void SnapshotXmlWriter::add_endpoint(
+        std::size_t participant,
+        const GUID_t& guid,
+        const InternedString& type,
+        const InternedString& topic,
+        bool reader)
+{
+    auto res = endpoint_rows_.emplace(guid, endpoints_.size());
+
+    if (res.second)
+    {
+        endpoints_.push_back({guid, type, topic, reader, -1});
+        participants_[participant].endpoints.push_back(res.first->second);
+    }
+}
+
+void SnapshotXmlWriter::write_references(
+        const Snapshot& sh,
+        const ParticipantDiscoveryDatabase& discovery_database)
+{
+    for (const ParticipantDiscoveryItem& discovery_item : discovery_database)
+    {
+        std::size_t id = participant_rows_.at(discovery_item.endpoint_guid);
+        const ParticipantDiscoveryItem& row = *participants_[id].item;
+
+        open(s_sParticipantRef);
+        attribute(s_sId, static_cast<int64_t>(id));
+
+        if (discovery_item.is_server != row.is_server)
+        {
+            attribute(s_sServer, discovery_item.is_server);
+        }
+
+        if (discovery_item.is_alive != row.is_alive)
+        {
+            attribute(s_sAlive, discovery_item.is_alive);
+        }
+
+        if (discovery_item.participant_name != row.participant_name)
+        {
+            attribute(s_sName, discovery_item.participant_name.c_str());
+        }
+
+        attribute(s_sDiscovered_timestamp, ms(discovery_item.discovered_timestamp_ - sh.process_startup_));
+
+        for (const DataReaderDiscoveryItem& sub : discovery_item.getDataReaders())
+        {
+            const EndpointRow& endpoint = endpoints_[endpoint_rows_.at(sub.endpoint_guid)];
+
+            open(s_sSubscriberRef);
+            attribute(s_sId, endpoint.id);
+
+            if (sub.type_name != endpoint.type)
+            {
+                attribute(s_sType, sub.type_name.c_str());
+            }
+
+            if (sub.topic_name != endpoint.topic)
+            {
+                attribute(s_sTopic, sub.topic_name.c_str());
+            }
+
+            attribute(s_sDiscovered_timestamp, ms(sub.discovered_timestamp_ - sh.process_startup_));
+
+            if (sh.show_liveliness_ &&
+                    (sub.endpoint_guid.guidPrefix == discovery_database.endpoint_guid.guidPrefix))
+            {
+                attribute(s_sAliveCount, static_cast<int64_t>(sub.alive_count));
+                attribute(s_sNotAliveCount, static_cast<int64_t>(sub.not_alive_count));
+            }
+
+            close();
+        }
+
+        for (const DataWriterDiscoveryItem& pub : discovery_item.getDataWriters())
+        {
+            const EndpointRow& endpoint = endpoints_[endpoint_rows_.at(pub.endpoint_guid)];
+
+            open(s_sPublisherRef);
+            attribute(s_sId, endpoint.id);
+
+            if (pub.type_name != endpoint.type)
+            {
+                attribute(s_sType, pub.type_name.c_str());
+            }
+
+            if (pub.topic_name != endpoint.topic)
+            {
+                attribute(s_sTopic, pub.topic_name.c_str());
+            }
+
+            attribute(s_sDiscovered_timestamp, ms(pub.discovered_timestamp_ - sh.process_startup_));
+            close();
+        }
+
+        close();
+    }
+}
+
+void SnapshotXmlWriter::open(
+        const std::string& name)
+{
+    seal();
+    stack_.push_back(&name);
+
+    if (text_depth_ < 0 && !first_)
+    {
+        new_line();
+    }
+
+    out_ << '<' << name;
+
+    just_opened_ = true;
+    first_ = false;
+    ++depth_;
+}
+
+void SnapshotXmlWriter::attribute(
+        const std::string& name,
+        const char* value)
+{
+    out_ << ' ' << name << "=\"";
+    escape(value, false);
+    out_ << '"';
+}
+
+void SnapshotXmlWriter::attribute(
+        const std::string& name,
+        int64_t value)
+{
+    out_ << ' ' << name << "=\"" << value << '"';
+}
+
+void SnapshotXmlWriter::attribute(
+        const std::string& name,
+        bool value)
+{
+    out_ << ' ' << name << "=\"" << (value ? "true" : "false") << '"';
+}
+
+template<class Id>
+void SnapshotXmlWriter::attribute_id(
+        const std::string& name,
+        const Id& id)
+{
+    // guids have nothing to escape
+    char text[guid_codec::prefix_size];
+    std::size_t length = guid_codec::Encode(id, text);
+    out_ << ' ' << name << "=\"";
+    out_.write(text, length);
+    out_ << '"';
+}
+
+void SnapshotXmlWriter::text(
+        const char* value)
+{
+    text_depth_ = depth_ - 1;
+    seal();
+    escape(value, true);
+}
+
+void SnapshotXmlWriter::close()
+{
+    --depth_;
+    const std::string& name = *stack_.back();
+    stack_.pop_back();
+
+    if (just_opened_)
+    {
+        out_ << "/>";
+    }
+    else
+    {
+        if (text_depth_ < 0)
+        {
+            new_line();
+        }
+
+        out_ << "</" << name << '>';
+    }
+
+    if (text_depth_ == depth_)
+    {
+        text_depth_ = -1;
+    }
+
+    if (depth_ == 0)
+    {
+        out_ << '\n';
+    }
+
+    just_opened_ = false;
+}
+
+void SnapshotXmlWriter::seal()
+{
+    if (just_opened_)
+    {
+        just_opened_ = false;
+        out_ << '>';
+    }
+}
+
+void SnapshotXmlWriter::new_line()
+{
+    out_ << '\n';
+
+    for (int i = 0; i < depth_; ++i)
+    {
+        out_ << "    ";
+    }
+}
+
+void SnapshotXmlWriter::escape(
+        const char* value,
+        bool text)
+{
+    // text only escapes the markup characters, attributes the quotes too
+    const char* run = value;
+
+    for (const char* p = value; *p != '\0'; ++p)
+    {
+        const char* entity = nullptr;
+
+        switch (*p)
+        {
+            case '&':
+                entity = "&amp;";
+                break;
+            case '<':
+                entity = "&lt;";
+                break;
+            case '>':
+                entity = "&gt;";
+                break;
+            case '"':
+                entity = text ? nullptr : "&quot;";
+                break;
+            case '\'':
+                entity = text ? nullptr : "&apos;";
+                break;
+            default:
+                break;
+        }
+
+        if (entity != nullptr)
+        {
+            out_.write(run, p - run);
+            out_ << entity;
+            run = p + 1;
+        }
+    }
+
+    out_ << run;
+}
+
+bool eprosima::discovery_server::SaveXmlSnapshots(
+        const std::string& file,
+        const std::vector<Snapshot>& snapshots,
+        bool normalized)
+{
+    // text mode as tinyxml2 SaveFile
+    std::vector<char> buffer(s_buffer_size);
+    std::ofstream out;
+    out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    out.open(file, std::ios::out | std::ios::trunc);
+
+    SnapshotXmlWriter writer(out, normalized);
+    writer.Begin();
+
+    for (const Snapshot& sh : snapshots)
+    {
+        LOG("Saving snapshot " << sh._des);
+        writer.Write(sh);
+    }
+
+    writer.End();
+
+    return static_cast<bool>(out.flush());
+}
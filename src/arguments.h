@@ -24,7 +24,13 @@ enum  optionIndex
     HELP,
     CONFIG_FILE,
     OUTPUT_FILE,
-    SHM
+    SHM,
+    ZOMBIE_GRACE_PERIOD,
+    BINARY_SNAPSHOTS,
+    SNAPSHOT_DESCRIPTION,
+    NORMALIZED_SNAPSHOTS,
+    INGESTION_QUEUE,
+    STAGING_BUFFERS
 };
 
 struct Arg : public option::Arg
@@ -32,6 +38,11 @@ struct Arg : public option::Arg
     static option::ArgStatus check_inp(
             const option::Option& option,
             bool msg);
+
+    //! the argument must be a whole non negative number of seconds
+    static option::ArgStatus check_seconds(
+            const option::Option& option,
+            bool msg);
 };
 
 const option::Descriptor usage[] = {
@@ -53,6 +64,30 @@ const option::Descriptor usage[] = {
     { SHM,    0, "s",  "disabled-shared-memory",       Arg::None,
       "  -s \t--shared-memory     Disable Shared Memory.\n" },
 
+    { ZOMBIE_GRACE_PERIOD,  0, "z", "zombie-grace-period",    Arg::check_seconds,
+      "  -z \t--zombie-grace-period  Seconds a participant reported dead is kept while it still owns"
+      " endpoints. Overrides the config file value, 0 keeps them forever\n"},
+
+    { BINARY_SNAPSHOTS,    0, "b",  "binary-snapshots",       Arg::None,
+      "  -b \t--binary-snapshots  Write the result snapshots in the memory mappable binary format."
+      " Output files with the .dssnap extension always use it\n" },
+
+    { SNAPSHOT_DESCRIPTION,  0, "d", "snapshot-description",    Arg::check_inp,
+      "  -d \t--snapshot-description  When the config file is a snapshot file only the snapshots with"
+      " this description are loaded. May be repeated\n"},
+
+    { NORMALIZED_SNAPSHOTS,    0, "n",  "normalized-snapshots",       Arg::None,
+      "  -n \t--normalized-snapshots  Write XML snapshots listing each participant and endpoint once,"
+      " referenced by every database that discovered it. Ignored for binary snapshots\n" },
+
+    { INGESTION_QUEUE,    0, "q",  "ingestion-queue",       Arg::None,
+      "  -q \t--ingestion-queue  Apply the discovery callbacks changes from a queue drained by a dedicated"
+      " thread. Overrides the config file ingestion_queue attribute\n" },
+
+    { STAGING_BUFFERS,    0, "t",  "staging-buffers",       Arg::None,
+      "  -t \t--staging-buffers  Apply the discovery callbacks changes from per thread staging buffers."
+      " Overrides the config file staging_buffers attribute\n" },
+
     { 0, 0, 0, 0, 0, 0 }
 };
 
@@ -20,6 +20,12 @@
 
 #include <fastdds/dds/domain/DomainParticipantFactory.hpp>
 
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <set>
+#include <string>
+
 #include "DiscoveryServerManager.h"
 #include "arguments.h"
 
@@ -114,14 +120,54 @@ int main(
         return 1;
     }
 
+    // Load zombie grace period, overrides the config file one. Arg::check_seconds already validated it
+    int zombie_grace = -1;
+    option::Option* pOp_zg = options[ZOMBIE_GRACE_PERIOD];
+    if ( nullptr != pOp_zg )
+    {
+        zombie_grace = std::stoi(pOp_zg->arg);
+    }
+
+    // Load the descriptions of the snapshots to validate, all of them if none
+    SnapshotFilter snapshot_filter;
+    if ( nullptr != options[SNAPSHOT_DESCRIPTION] )
+    {
+        std::set<std::string> descriptions;
+        for (option::Option* opt = options[SNAPSHOT_DESCRIPTION]; opt != nullptr; opt = opt->next())
+        {
+            descriptions.insert(opt->arg);
+        }
+
+        snapshot_filter = [descriptions](const std::string& description)
+                {
+                    return descriptions.count(description) != 0;
+                };
+    }
+
     int return_code = 0;
     std::string path_to_config = pOp->arg;
 
     // Load Default XML files
     DomainParticipantFactory::get_instance()->load_profiles();
 
+    // Load the ingestion mode, overrides the config file one
+    IngestionMode ingestion_mode = IngestionMode::CONFIG;
+    if ( nullptr != options[INGESTION_QUEUE] && nullptr != options[STAGING_BUFFERS] )
+    {
+        cout << "Only one ingestion mode can be specified: use either -q or -t option." << endl;
+        return 1;
+    }
+    else if ( nullptr != options[INGESTION_QUEUE] )
+    {
+        ingestion_mode = IngestionMode::INGESTION_QUEUE;
+    }
+    else if ( nullptr != options[STAGING_BUFFERS] )
+    {
+        ingestion_mode = IngestionMode::STAGING_BUFFERS;
+    }
+
     // Create DiscoveryServerManager
-    DiscoveryServerManager manager(path_to_config, options[SHM]);
+    DiscoveryServerManager manager(path_to_config, options[SHM], snapshot_filter, ingestion_mode);
     if (!manager.correctly_created())
     {
         return_code = 1;
@@ -134,6 +180,21 @@ int main(
         manager.output_file(pOp_of->arg);
     }
 
+    if ( nullptr != options[BINARY_SNAPSHOTS] )
+    {
+        manager.binary_snapshots(true);
+    }
+
+    if ( nullptr != options[NORMALIZED_SNAPSHOTS] )
+    {
+        manager.normalized_snapshots(true);
+    }
+
+    if ( zombie_grace >= 0 )
+    {
+        manager.zombie_grace_period(std::chrono::seconds(zombie_grace));
+    }
+
     // Follow the config file instructions
     manager.runEvents(std::cin, std::cout);
 
@@ -171,3 +232,30 @@ option::ArgStatus Arg::check_inp(
 
     return option::ARG_ILLEGAL;
 }
+
+/*static*/
+option::ArgStatus Arg::check_seconds(
+        const option::Option& option,
+        bool msg)
+{
+    // only digits, so signs, blanks and trailing characters are rejected
+    bool valid = nullptr != option.arg && '\0' != option.arg[0];
+
+    for (const char* c = option.arg; valid && '\0' != *c; ++c)
+    {
+        valid = 0 != std::isdigit(static_cast<unsigned char>(*c));
+    }
+
+    // must fit the int the period is loaded into
+    if ( valid && std::strtoul(option.arg, nullptr, 10) <= static_cast<unsigned long>(INT_MAX) )
+    {
+        return option::ARG_OK;
+    }
+
+    if ( msg )
+    {
+        cout << "Option --" << option.desc->longopt << " requires a non negative number of seconds." << endl;
+    }
+
+    return option::ARG_ILLEGAL;
+}
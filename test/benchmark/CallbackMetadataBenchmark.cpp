@@ -0,0 +1,185 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <fastdds/dds/builtin/topic/PublicationBuiltinTopicData.hpp>
+
+#include "DiscoveryServerManager.h"
+#include "TestHelpers.h"
+
+using namespace eprosima::discovery_server;
+using namespace eprosima::discovery_server::testing;
+
+namespace {
+
+//! remote participants reported to the server
+const uint32_t s_participants = 1000;
+
+//! writers and readers reported for each remote participant
+const uint32_t s_endpoints = 10;
+
+//! prefix of the server on the benchmark configuration
+const octet s_server_prefix[12] = {0x44, 0x49, 0x53, 0x43, 0x42, 0x45, 0x4E, 0x43, 0x48, 0x4D, 0x4B, 0x31};
+
+GUID_t make_endpoint_guid(
+        uint32_t index,
+        uint32_t endpoint,
+        octet kind)
+{
+    GUID_t guid = make_participant_guid(index);
+    guid.entityId.value[2] = static_cast<octet>(endpoint);
+    guid.entityId.value[3] = kind;
+    return guid;
+}
+
+std::string make_name(
+        uint32_t index)
+{
+    return "benchmark_client_" + std::to_string(index);
+}
+
+//! runs the callbacks and returns the average ns per callback
+double time_callbacks(
+        std::size_t callbacks,
+        const std::function<void(std::size_t)>& callback)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t n = 0; n < callbacks; ++n)
+    {
+        callback(n);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / callbacks;
+}
+
+void report(
+        const char* path,
+        std::size_t callbacks,
+        double ns)
+{
+    std::cout << std::fixed << std::setprecision(1)
+              << path << ": " << callbacks << " callbacks, " << ns << " ns/callback" << std::endl;
+}
+
+} // namespace
+
+// times the discovery callbacks of a server the way Fast DDS calls them, the numbers are only reported.
+// Run it by hand with callback_metadata.xml, it is not registered on ctest
+int main(
+        int argc,
+        char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <benchmark configuration>" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    DiscoveryServerManager manager(argv[1], true);
+
+    GUID_t server_guid;
+    std::copy(s_server_prefix, s_server_prefix + 12, server_guid.guidPrefix.value);
+    server_guid.entityId = c_EntityId_RTPSParticipant;
+
+    DomainParticipant* server = manager.correctly_created() ? manager.getParticipant(server_guid) : nullptr;
+
+    if (server == nullptr)
+    {
+        std::cerr << "The benchmark server could not be created from " << argv[1] << std::endl;
+        manager.onTerminate();
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t endpoints = s_participants * s_endpoints;
+    bool ignore = false;
+
+    // the callbacks arguments are built beforehand, only the callbacks are timed
+    std::vector<ParticipantBuiltinTopicData> participants_info(s_participants);
+    std::vector<PublicationBuiltinTopicData> writers_info(endpoints);
+    std::vector<SubscriptionBuiltinTopicData> readers_info(endpoints);
+
+    for (uint32_t i = 0; i < s_participants; ++i)
+    {
+        participants_info[i].guid = make_participant_guid(i);
+        participants_info[i].participant_name = make_name(i);
+    }
+
+    for (std::size_t n = 0; n < endpoints; ++n)
+    {
+        uint32_t index = static_cast<uint32_t>(n % s_participants);
+        uint32_t endpoint = static_cast<uint32_t>(n / s_participants);
+        std::string topic = "benchmark_topic_" + std::to_string(endpoint);
+
+        writers_info[n].guid = make_endpoint_guid(index, endpoint, 0x03);
+        writers_info[n].participant_guid = participants_info[index].guid;
+        writers_info[n].topic_name = topic;
+        writers_info[n].type_name = "HelloWorld";
+
+        readers_info[n].guid = make_endpoint_guid(index, endpoint, 0x04);
+        readers_info[n].participant_guid = participants_info[index].guid;
+        readers_info[n].topic_name = topic;
+        readers_info[n].type_name = "HelloWorld";
+    }
+
+    double participants = time_callbacks(s_participants, [&](std::size_t n)
+                    {
+                        manager.on_participant_discovery(server, ParticipantDiscoveryStatus::DISCOVERED_PARTICIPANT,
+                        participants_info[n], ignore);
+                    });
+
+    double writers = time_callbacks(endpoints, [&](std::size_t n)
+                    {
+                        manager.on_data_writer_discovery(server, WriterDiscoveryStatus::DISCOVERED_WRITER,
+                        writers_info[n], ignore);
+                    });
+
+    double readers = time_callbacks(endpoints, [&](std::size_t n)
+                    {
+                        manager.on_data_reader_discovery(server, ReaderDiscoveryStatus::DISCOVERED_READER,
+                        readers_info[n], ignore);
+                    });
+
+    double removed_writers = time_callbacks(endpoints, [&](std::size_t n)
+                    {
+                        manager.on_data_writer_discovery(server, WriterDiscoveryStatus::REMOVED_WRITER,
+                        writers_info[n], ignore);
+                    });
+
+    double removed_readers = time_callbacks(endpoints, [&](std::size_t n)
+                    {
+                        manager.on_data_reader_discovery(server, ReaderDiscoveryStatus::REMOVED_READER,
+                        readers_info[n], ignore);
+                    });
+
+    manager.onTerminate();
+
+    report("discovered participants", s_participants, participants);
+    report("discovered writers", endpoints, writers);
+    report("discovered readers", endpoints, readers);
+    report("removed writers", endpoints, removed_writers);
+    report("removed readers", endpoints, removed_readers);
+
+    return EXIT_SUCCESS;
+}
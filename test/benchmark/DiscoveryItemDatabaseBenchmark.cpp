@@ -0,0 +1,323 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DiscoveryArena.h"
+#include "DiscoveryItem.h"
+#include "GuidCodec.h"
+#include "SnapshotXmlReader.h"
+#include "TestHelpers.h"
+
+using namespace eprosima::fastdds::rtps;
+using namespace eprosima::discovery_server;
+using namespace eprosima::discovery_server::testing;
+
+namespace {
+
+//! number of callbacks timed on each population
+const std::size_t s_callbacks = 20000;
+
+//! the cost per callback on the largest population may not exceed this multiple of the smallest one,
+//! logarithmic lookups stay well below it while linear ones grow with the 500 times larger population
+const double s_max_growth = 20.0;
+
+//! populations to benchmark
+const std::vector<std::size_t> s_populations = {100, 1000, 10000, 50000};
+
+//! populates a database and returns the average cost in nanoseconds of a discovery callback
+double benchmark_callbacks(
+        std::size_t population)
+{
+    DiscoveryItemDatabase database;
+    const std::string src_name("benchmark");
+    const GUID_t spokesman = make_participant_guid(0);
+    const auto now = std::chrono::steady_clock::now();
+
+    // every participant owns a reader and a writer
+    uint64_t allocations = heap_allocations();
+
+    for (uint32_t i = 0; i < population; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.AddParticipant(spokesman, src_name, ptid, "participant", now);
+        database.AddDataReader(spokesman, src_name, ptid, make_endpoint_guid(ptid, 1), "type", "topic", now);
+        database.AddDataWriter(spokesman, src_name, ptid, make_endpoint_guid(ptid, 2), "type", "topic", now);
+    }
+
+    std::cout << std::setw(8) << population << " participants: "
+              << double(heap_allocations() - allocations) / population << " heap allocations per participant" << std::endl;
+
+    // emulate the callback traffic over the whole population
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t n = 0; n < s_callbacks; ++n)
+    {
+        uint32_t i = static_cast<uint32_t>((n * 7919) % population);
+        GUID_t ptid = make_participant_guid(i);
+        GUID_t wid = make_endpoint_guid(ptid, 3);
+
+        database.AddDataWriter(spokesman, src_name, ptid, wid, "type", "topic", now);
+        database.CountDataWriters(spokesman, ptid);
+        database.RemoveDataWriter(spokesman, ptid, wid);
+        database.UpdateSubLiveliness(make_endpoint_guid(ptid, 1), 1, 0);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / s_callbacks;
+}
+
+//! heap allocations and arena nodes of a phase, nodes would each be a heap allocation without the arenas
+struct Allocations
+{
+    uint64_t heap = heap_allocations();
+    uint64_t nodes = DiscoveryArena::statistics().nodes;
+    uint64_t chunks = DiscoveryArena::statistics().chunks;
+
+    void report(
+            const char* phase) const
+    {
+        std::cout << phase << ": " << heap_allocations() - heap << " heap allocations, "
+                  << DiscoveryArena::statistics().nodes - nodes << " arena nodes on "
+                  << DiscoveryArena::statistics().chunks - chunks << " chunks" << std::endl;
+    }
+
+};
+
+//! allocations of a scenario of the reference snapshot size: loading it, replaying it as callbacks and copying it
+bool benchmark_snapshot_allocations(
+        const std::string& file)
+{
+    std::vector<Snapshot> shots;
+
+    {
+        Allocations loading;
+        SnapshotXmlReader reader;
+
+        if (!reader.Load(file, shots) || shots.empty())
+        {
+            std::cerr << "Cannot load " << file << ": " << reader.Error() << std::endl;
+            return false;
+        }
+
+        loading.report("xml snapshot load");
+    }
+
+    std::size_t participants = 0;
+    std::size_t endpoints = 0;
+    const auto now = std::chrono::steady_clock::now();
+    DiscoveryItemDatabase database;
+
+    {
+        Allocations replay;
+
+        // each spokesman reports what the snapshot shows
+        for (const ParticipantDiscoveryDatabase& discovery_database : shots.front())
+        {
+            const GUID_t& spokesman = discovery_database.endpoint_guid;
+
+            for (const ParticipantDiscoveryItem& item : discovery_database)
+            {
+                database.AddParticipant(spokesman, "replay", item.endpoint_guid, item.participant_name, now,
+                        item.is_server);
+                ++participants;
+
+                for (const DataReaderDiscoveryItem& sub : item.getDataReaders())
+                {
+                    database.AddDataReader(spokesman, "replay", item.endpoint_guid, sub.endpoint_guid,
+                            sub.type_name, sub.topic_name, now);
+                    ++endpoints;
+                }
+
+                for (const DataWriterDiscoveryItem& pub : item.getDataWriters())
+                {
+                    database.AddDataWriter(spokesman, "replay", item.endpoint_guid, pub.endpoint_guid,
+                            pub.type_name, pub.topic_name, now);
+                    ++endpoints;
+                }
+            }
+        }
+
+        std::cout << "replay: " << shots.front().size() << " spokesmen, " << participants << " participants, "
+                  << endpoints << " endpoints" << std::endl;
+        replay.report("replay callbacks");
+    }
+
+    {
+        Allocations state;
+        Snapshot shot = database.GetState();
+        state.report("database snapshot");
+    }
+
+    {
+        Allocations copy;
+        Snapshot shot = shots.front();
+        copy.report("loaded snapshot copy");
+    }
+
+    return true;
+}
+
+//! every guid in the snapshots, in file order
+std::vector<GUID_t> collect_guids(
+        const std::vector<Snapshot>& shots)
+{
+    std::vector<GUID_t> guids;
+
+    for (const Snapshot& sh : shots)
+    {
+        for (const ParticipantDiscoveryDatabase& discovery_database : sh)
+        {
+            guids.push_back(discovery_database.endpoint_guid);
+
+            for (const ParticipantDiscoveryItem& discovery_item : discovery_database)
+            {
+                guids.push_back(discovery_item.endpoint_guid);
+
+                for (const DataReaderDiscoveryItem& sub : discovery_item.getDataReaders())
+                {
+                    guids.push_back(sub.endpoint_guid);
+                }
+
+                for (const DataWriterDiscoveryItem& pub : discovery_item.getDataWriters())
+                {
+                    guids.push_back(pub.endpoint_guid);
+                }
+            }
+        }
+    }
+
+    return guids;
+}
+
+//! times the snapshot guids round trip with the codec and as the stringstream code it replaced
+bool benchmark_guid_codec(
+        const std::string& file)
+{
+    std::vector<Snapshot> shots;
+    SnapshotXmlReader reader;
+
+    if (!reader.Load(file, shots))
+    {
+        std::cerr << "Cannot load " << file << ": " << reader.Error() << std::endl;
+        return false;
+    }
+
+    const std::vector<GUID_t> guids = collect_guids(shots);
+    char prefix_text[guid_codec::prefix_size];
+    char entity_text[guid_codec::entity_size];
+
+    // as the replaced code: a fresh stream per id in both directions
+    const std::size_t rounds = 50;
+    std::size_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (const GUID_t& guid : guids)
+        {
+            std::string prefix;
+            std::string entity;
+            {
+                std::stringstream sstream;
+                sstream << guid.guidPrefix;
+                prefix = sstream.str();
+            }
+            {
+                std::stringstream sstream;
+                sstream << guid.entityId;
+                entity = sstream.str();
+            }
+
+            GUID_t decoded;
+            {
+                std::stringstream sstream;
+                sstream << prefix;
+                sstream >> decoded.guidPrefix;
+            }
+            {
+                std::stringstream sstream;
+                sstream << entity;
+                sstream >> decoded.entityId;
+            }
+            checksum += decoded.guidPrefix.value[11];
+        }
+    }
+
+    const auto streams = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+
+    for (std::size_t round = 0; round < rounds; ++round)
+    {
+        for (const GUID_t& guid : guids)
+        {
+            guid_codec::Encode(guid.guidPrefix, prefix_text);
+            guid_codec::Encode(guid.entityId, entity_text);
+
+            GUID_t decoded;
+            guid_codec::Decode(prefix_text, decoded.guidPrefix);
+            guid_codec::Decode(entity_text, decoded.entityId);
+            checksum -= decoded.guidPrefix.value[11];
+        }
+    }
+
+    const auto codec = std::chrono::steady_clock::now() - start;
+
+    const double count = static_cast<double>(rounds * guids.size());
+    const double stream_ns = std::chrono::duration<double, std::nano>(streams).count() / count;
+    const double codec_ns = std::chrono::duration<double, std::nano>(codec).count() / count;
+
+    // the checksum keeps both loops alive
+    std::cout << guids.size() << " snapshot guids: stringstream " << std::fixed << std::setprecision(1)
+              << stream_ns << " ns/guid, codec " << codec_ns << " ns/guid, speedup " << stream_ns / codec_ns
+              << (checksum != 0 ? " (round trips differ)" : "") << std::endl;
+
+    return true;
+}
+
+} // namespace
+
+// fails when the callback cost grows faster than logarithmic lookups allow, the database checks are the
+// discovery_server_database tests
+int main(
+        int argc,
+        char** argv)
+{
+    std::vector<double> costs;
+
+    for (std::size_t population : s_populations)
+    {
+        costs.push_back(benchmark_callbacks(population));
+        std::cout << std::setw(8) << population << " participants: "
+                  << std::fixed << std::setprecision(1) << costs.back() << " ns/callback" << std::endl;
+    }
+
+    double growth = costs.back() / costs.front();
+    std::cout << "growth factor " << growth << " (limit " << s_max_growth << ")" << std::endl;
+
+    // the ctest passes the reference snapshot
+    if (argc > 1 && (!benchmark_snapshot_allocations(argv[1]) || !benchmark_guid_codec(argv[1])))
+    {
+        return EXIT_FAILURE;
+    }
+
+    return growth > s_max_growth ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,1223 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <tinyxml2.h>
+
+#include <fastcdr/cdr/fixed_size_string.hpp>
+
+#include "DiscoveryArena.h"
+#include "DiscoveryEventQueue.h"
+#include "DiscoveryItem.h"
+#include "GuidCodec.h"
+#include "SnapshotBinary.h"
+#include "SnapshotXmlReader.h"
+#include "SnapshotXmlWriter.h"
+#include "TestHelpers.h"
+
+using namespace eprosima::fastdds::rtps;
+using namespace eprosima::discovery_server;
+using namespace eprosima::discovery_server::testing;
+
+namespace {
+
+//! every endpoint must be matched on its topic and queries on unknown names must not intern them
+bool check_topic_queries()
+{
+    const uint32_t population = 1000;
+    const GUID_t spokesman = make_participant_guid(0);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    // every participant owns a reader and a writer on the same topic
+    for (uint32_t i = 0; i < population; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.AddParticipant(spokesman, "queries", ptid, "participant", now);
+        database.AddDataReader(spokesman, "queries", ptid, make_endpoint_guid(ptid, 1), "QueryType", "QueryTopic",
+                now);
+        database.AddDataWriter(spokesman, "queries", ptid, make_endpoint_guid(ptid, 2), "QueryType", "QueryTopic",
+                now);
+    }
+
+    TopicMatches matches = database.QueryTopic("QueryTopic");
+
+    if (matches.matched_writers.size() != population || matches.matched_readers.size() != population
+            || !database.UnmatchedTopics().empty())
+    {
+        std::cerr << "Topic index matched " << matches.matched_writers.size() << " writers and "
+                  << matches.matched_readers.size() << " readers" << std::endl;
+        return false;
+    }
+
+    std::size_t symbols = InternedString::symbols();
+
+    if (!database.QueryTopic("never reported").matched_writers.empty() || InternedString::symbols() != symbols)
+    {
+        std::cerr << "Topic query interned an unknown name" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//! counts the heap allocations of each endpoint callback ingestion, names must be copied at most once
+bool check_ingestion_allocations()
+{
+    // few enough names to keep the interned string table from growing
+    const uint32_t names = 200;
+    const InternedString src_name("tests");
+    const GUID_t spokesman = make_participant_guid(0);
+    const auto now = std::chrono::steady_clock::now();
+
+    // names as received on the builtin topic data, longer than any inline string buffer
+    std::vector<eprosima::fastcdr::string_255> type_names;
+    std::vector<eprosima::fastcdr::string_255> topic_names;
+
+    for (uint32_t i = 0; i < names; ++i)
+    {
+        type_names.emplace_back(("ingestion_test_type_" + std::to_string(i)).c_str());
+        topic_names.emplace_back(("ingestion_test_topic_" + std::to_string(i)).c_str());
+    }
+
+    DiscoveryItemDatabase database;
+    uint64_t new_names = 0;
+    uint64_t new_name_allocations = 0;
+    uint64_t known_allocations = 0;
+
+    // the first round reports new names, the second one reports the same endpoints again
+    for (int round = 0; round < 2; ++round)
+    {
+        for (uint32_t i = 0; i < names; ++i)
+        {
+            GUID_t ptid = make_participant_guid(i + 1);
+            std::size_t symbols = InternedString::symbols();
+            uint64_t allocations = heap_allocations();
+
+            DiscoveryEvent event = DiscoveryEvent::AddDataWriter(spokesman, src_name, ptid,
+                            make_endpoint_guid(ptid, 1),
+                            InternedString(type_names[i].c_str(), type_names[i].size()),
+                            InternedString(topic_names[i].c_str(), topic_names[i].size()),
+                            now);
+
+            uint64_t interning = heap_allocations() - allocations;
+            uint64_t callback_names = InternedString::symbols() - symbols;
+
+            event.apply(database);
+
+            if (interning > callback_names)
+            {
+                std::cerr << "Callback " << i << " allocated " << interning << " times for "
+                          << callback_names << " new names" << std::endl;
+                return false;
+            }
+
+            if (round == 0)
+            {
+                new_names += callback_names;
+                new_name_allocations += interning;
+            }
+            else
+            {
+                known_allocations += heap_allocations() - allocations;
+            }
+        }
+    }
+
+    std::cout << "ingestion: " << double(new_name_allocations) / new_names << " heap allocations per new name, "
+              << double(known_allocations) / names << " per known endpoint callback" << std::endl;
+
+    return known_allocations == 0;
+}
+
+//! container nodes served by all the arenas so far
+uint64_t arena_nodes()
+{
+    return DiscoveryArena::statistics().nodes;
+}
+
+//! published versions must only be copied by writes that change something while they are alive
+bool check_copy_on_write()
+{
+    const uint32_t population = 1000;
+    const GUID_t spokesman = make_participant_guid(0);
+    const GUID_t unknown = make_participant_guid(population + 1);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    for (uint32_t i = 0; i < population; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.AddParticipant(spokesman, "tests", ptid, "cow", now);
+        database.AddDataReader(spokesman, "tests", ptid, make_endpoint_guid(ptid, 1), "CowType", "CowTopic", now);
+    }
+
+    std::unique_ptr<Snapshot> shot(new Snapshot(database.GetState()));
+
+    // misses leave the published version alone
+    uint64_t nodes = arena_nodes();
+    bool missed = !database.RemoveParticipant(spokesman, unknown)
+            && !database.RemoveDataReader(spokesman, unknown, make_endpoint_guid(unknown, 1));
+    database.UpdateSubLiveliness(make_endpoint_guid(spokesman, 7), 1, 0);
+    uint64_t miss_nodes = arena_nodes() - nodes;
+
+    // a hit copies the path to the participant only, the snapshot keeps the rest
+    GUID_t first = make_participant_guid(population / 4);
+    nodes = arena_nodes();
+    database.AddDataWriter(spokesman, "tests", first, make_endpoint_guid(first, 2), "CowType", "CowTopic", now);
+    uint64_t shared_write_nodes = arena_nodes() - nodes;
+
+    if (shot->begin()->CountDataWriters() != 0 || database.CountDataWriters(spokesman) != 1)
+    {
+        std::cerr << "Copy on write modified the snapshot" << std::endl;
+        return false;
+    }
+
+    // once released the next write modifies in place
+    shot.reset();
+    GUID_t ptid = make_participant_guid(population / 2);
+    nodes = arena_nodes();
+    database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, 2), "CowType", "CowTopic", now);
+    uint64_t write_nodes = arena_nodes() - nodes;
+
+    std::cout << "copy on write: " << population << " participants, " << miss_nodes << " nodes allocated on misses, "
+              << shared_write_nodes << " on the first write with the snapshot alive, " << write_nodes
+              << " after releasing it" << std::endl;
+
+    return missed && miss_nodes == 0 && shared_write_nodes < population / 10 && write_nodes < population / 10;
+}
+
+//! spokesmen reporting concurrently must leave the striped indexes consistent
+bool check_concurrent_indexes()
+{
+    const uint32_t spokesmen = 4;
+    const uint32_t population = 256;
+    const uint32_t topics = 8;
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+    std::vector<InternedString> topic_names;
+
+    for (uint32_t t = 0; t < topics; ++t)
+    {
+        topic_names.emplace_back("StripeTopic" + std::to_string(t));
+    }
+
+    auto run = [&](bool add)
+            {
+                std::vector<std::thread> threads;
+
+                for (uint32_t s = 0; s < spokesmen; ++s)
+                {
+                    threads.emplace_back([&, s]()
+                            {
+                                GUID_t spokesman = make_participant_guid(1000000 + s);
+
+                                for (uint32_t i = 0; i < population; ++i)
+                                {
+                                    GUID_t ptid = make_participant_guid(i);
+                                    const InternedString& topic = topic_names[i % topics];
+
+                                    if (add)
+                                    {
+                                        database.AddParticipant(spokesman, "stripes", ptid, "striped", now);
+                                        database.AddDataWriter(spokesman, "stripes", ptid, make_endpoint_guid(ptid, 1),
+                                                "StripeType", topic, now);
+                                        database.AddDataReader(spokesman, "stripes", ptid, make_endpoint_guid(ptid, 2),
+                                                "StripeType", topic, now);
+                                    }
+                                    else
+                                    {
+                                        database.RemoveDataWriter(spokesman, ptid, make_endpoint_guid(ptid, 1));
+                                        database.RemoveDataReader(spokesman, ptid, make_endpoint_guid(ptid, 2));
+                                        database.RemoveParticipant(spokesman, ptid);
+                                    }
+                                }
+                            });
+                }
+
+                for (std::thread& t : threads)
+                {
+                    t.join();
+                }
+            };
+
+    run(true);
+
+    for (uint32_t t = 0; t < topics; ++t)
+    {
+        TopicMatches matches = database.QueryTopic(topic_names[t].str());
+
+        if (matches.matched_writers.size() != population / topics
+                || matches.matched_readers.size() != population / topics
+                || matches.matched_writers.front().spokesmen.size() != spokesmen)
+        {
+            std::cerr << "Topic index lost concurrent reports on " << topic_names[t] << std::endl;
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < population; ++i)
+    {
+        if (database.CountSpokesmen(make_participant_guid(i)) != spokesmen)
+        {
+            std::cerr << "Participant index lost concurrent reports" << std::endl;
+            return false;
+        }
+    }
+
+    run(false);
+
+    return database.UnmatchedTopics().empty() && database.QueryTopic(topic_names[0].str()).matched_writers.empty()
+           && database.CountSpokesmen(make_participant_guid(0)) == 0;
+}
+
+//! zombies must only be reaped once their grace period expires, taking their endpoints with them
+bool check_zombie_reaper()
+{
+    const uint32_t zombies = 100;
+    const InternedString type_name("ReaperType");
+    const InternedString topic_name("ReaperTopic");
+    const GUID_t spokesman = make_participant_guid(0);
+    const std::chrono::hours grace(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    // one alive participant and the zombies, all of them with a writer
+    for (uint32_t i = 0; i <= zombies; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i + 1);
+        database.AddParticipant(spokesman, "tests", ptid, "reaper_" + std::to_string(i), now);
+        database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, topic_name, now);
+
+        if (i > 0)
+        {
+            database.RemoveParticipant(spokesman, ptid);
+        }
+    }
+
+    if (database.CountZombies() != zombies || database.ReapZombies(grace) != 0)
+    {
+        std::cerr << "Zombies reaped before the grace period expired" << std::endl;
+        return false;
+    }
+
+    // the statistics are logged periodically, they must not make the next write copy the shard
+    ZombieStatistics before = database.GetZombieStatistics();
+    GUID_t alive_ptid = make_participant_guid(1);
+    uint64_t nodes = arena_nodes();
+    database.AddDataReader(spokesman, "tests", alive_ptid, make_endpoint_guid(alive_ptid, 2), type_name,
+            topic_name, now);
+    nodes = arena_nodes() - nodes;
+
+    if (nodes >= zombies)
+    {
+        std::cerr << "Zombie statistics made the next write copy " << nodes << " nodes" << std::endl;
+        return false;
+    }
+
+    std::size_t reaped = database.ReapZombies(grace, std::chrono::steady_clock::now() + 2 * grace);
+    ZombieStatistics after = database.GetZombieStatistics();
+
+    std::cout << "reaper: " << before << std::endl << "reaper: " << after << std::endl;
+
+    GUID_t reaped_ptid = make_participant_guid(2);
+
+    return before.zombies == zombies && before.ages[0] == zombies
+           && reaped == zombies && after.zombies == 0 && after.reaped == zombies
+           && database.CountDataWriters() == 1
+           && database.QueryTopic("ReaperTopic").matched_writers.size() == 1
+           && database.CountSpokesmen(reaped_ptid) == 0
+           && !database.RemoveDataWriter(spokesman, reaped_ptid, make_endpoint_guid(reaped_ptid, 1));
+}
+
+//! the running totals must match a full recount of the state after the step
+bool counters_match(
+        const DiscoveryItemDatabase& database,
+        const char* step)
+{
+    std::size_t alive = 0;
+    std::size_t zombies = 0;
+    std::size_t readers = 0;
+    std::size_t writers = 0;
+
+    for (const ParticipantDiscoveryDatabase& discovery_database : database.GetState())
+    {
+        for (const ParticipantDiscoveryItem& item : discovery_database)
+        {
+            ++(item.is_alive ? alive : zombies);
+            readers += item.getDataReaders().size();
+            writers += item.getDataWriters().size();
+        }
+    }
+
+    if (database.CountParticipants() != alive + zombies || database.CountZombies() != zombies
+            || database.CountDataReaders() != readers || database.CountDataWriters() != writers)
+    {
+        std::cerr << "Counters differ from the recount after " << step << ": "
+                  << database.CountParticipants() << "/" << alive + zombies << " participants, "
+                  << database.CountZombies() << "/" << zombies << " zombies, "
+                  << database.CountDataReaders() << "/" << readers << " readers, "
+                  << database.CountDataWriters() << "/" << writers << " writers" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//! the totals kept by the modifiers must survive every way a participant leaves the database
+bool check_counters()
+{
+    const uint32_t population = 20;
+    const InternedString type_name("CountersType");
+    const InternedString topic_name("CountersTopic");
+    const GUID_t spokesman = make_participant_guid(0);
+    const GUID_t other_spokesman = make_participant_guid(1000);
+    const std::chrono::hours grace(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    // both spokesmen report every participant with a writer and a reader
+    for (uint32_t i = 1; i <= population; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+
+        for (const GUID_t& reporter : {spokesman, other_spokesman})
+        {
+            database.AddParticipant(reporter, "tests", ptid, "counters_" + std::to_string(i), now);
+            database.AddDataWriter(reporter, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, topic_name, now);
+            database.AddDataReader(reporter, "tests", ptid, make_endpoint_guid(ptid, 2), type_name, topic_name, now);
+        }
+    }
+
+    if (!counters_match(database, "discovery"))
+    {
+        return false;
+    }
+
+    // the first half dies while owning endpoints
+    for (uint32_t i = 1; i <= population / 2; ++i)
+    {
+        database.RemoveParticipant(spokesman, make_participant_guid(i));
+    }
+
+    if (!counters_match(database, "alive to zombie") || database.CountZombies() != population / 2)
+    {
+        return false;
+    }
+
+    // removing the last endpoint of a zombie erases it
+    for (uint32_t i = 1; i <= population / 4; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.RemoveDataWriter(spokesman, ptid, make_endpoint_guid(ptid, 1));
+        database.RemoveDataReader(spokesman, ptid, make_endpoint_guid(ptid, 2));
+    }
+
+    if (!counters_match(database, "zombie endpoints removal") || database.CountZombies() != population / 4)
+    {
+        return false;
+    }
+
+    // the other spokesman leaves with everything it reported
+    database.RemoveParticipant(other_spokesman);
+
+    if (!counters_match(database, "spokesman removal"))
+    {
+        return false;
+    }
+
+    std::size_t reaped = database.ReapZombies(grace, now + 2 * grace);
+
+    return counters_match(database, "reaping") && reaped == population / 4 && database.CountZombies() == 0;
+}
+
+//! each mutation must be journaled once, in order, and replayable from any retained sequence
+bool check_journal()
+{
+    typedef JournalEntry::Kind K;
+
+    const InternedString type_name("JournalType");
+    const InternedString topic_name("JournalTopic");
+    const GUID_t spokesman = make_participant_guid(0);
+    const GUID_t ptid = make_participant_guid(1);
+    const GUID_t writer = make_endpoint_guid(ptid, 1);
+    const GUID_t reader = make_endpoint_guid(ptid, 2);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+    uint64_t start = database.LastSequence();
+
+    database.AddParticipant(spokesman, "tests", ptid, "journal", now);
+    database.AddParticipant(spokesman, "tests", ptid, "journal", now); // no change
+    database.AddDataWriter(spokesman, "tests", ptid, writer, type_name, topic_name, now);
+    database.AddDataReader(spokesman, "tests", ptid, reader, type_name, topic_name, now);
+
+    uint64_t half;
+    Snapshot shot = database.GetState(half);
+
+    database.RemoveParticipant(spokesman, ptid);
+    database.RemoveDataWriter(spokesman, ptid, writer);
+    database.RemoveDataReader(spokesman, ptid, reader);
+    database.RemoveParticipant(spokesman);
+
+    const std::vector<K> expected = {K::ADD_PARTICIPANT, K::ADD_DATAWRITER, K::ADD_DATAREADER,
+                                     K::ZOMBIE_PARTICIPANT, K::REMOVE_DATAWRITER, K::REMOVE_DATAREADER,
+                                     K::REMOVE_PARTICIPANT, K::REMOVE_SPOKESMAN};
+
+    std::vector<JournalEntry> all;
+    std::vector<JournalEntry> tail;
+
+    if (!database.ChangesSince(start, all) || !database.ChangesSince(half, tail)
+            || all.size() != expected.size() || half != start + 3 || tail.size() != expected.size() - 3
+            || shot.empty())
+    {
+        std::cerr << "Unexpected journal size " << all.size() << " from " << start << " and " << tail.size()
+                  << " from " << half << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        if (all[i].kind != expected[i] || all[i].sequence != start + i + 1)
+        {
+            std::cerr << "Unexpected journal entry " << all[i] << std::endl;
+            return false;
+        }
+    }
+
+    // a bounded journal tells the consumer when it fell behind
+    DiscoveryJournal journal(4);
+    std::vector<JournalEntry> changes;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        journal.Record(JournalEntry());
+    }
+
+    if (!(!journal.Since(5, changes) && journal.Since(6, changes) && changes.size() == 4
+            && changes.front().sequence == 7 && journal.FirstSequence() == 7 && all[1].topic_name == topic_name))
+    {
+        return false;
+    }
+
+    // concurrent writers get consecutive sequences and keep their own order
+    const int writers = 4;
+    const int records = 5000;
+    DiscoveryJournal shared_journal;
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < writers; ++w)
+    {
+        threads.emplace_back([&, w]()
+                {
+                    for (int i = 0; i < records; ++i)
+                    {
+                        JournalEntry entry;
+                        entry.spokesman = make_participant_guid(w);
+                        entry.alive_count = i;
+                        shared_journal.Record(std::move(entry));
+                    }
+                });
+    }
+
+    for (std::thread& t : threads)
+    {
+        t.join();
+    }
+
+    std::vector<JournalEntry> recorded;
+    std::vector<int32_t> next(writers, 0);
+
+    if (!shared_journal.Since(0, recorded) || recorded.size() != writers * records)
+    {
+        std::cerr << "Concurrent journal kept " << recorded.size() << " entries" << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < recorded.size(); ++i)
+    {
+        int32_t& expected_count = next[recorded[i].spokesman.guidPrefix.value[11]];
+
+        if (recorded[i].sequence != i + 1 || recorded[i].alive_count != expected_count++)
+        {
+            std::cerr << "Concurrent journal entry out of order " << recorded[i] << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//! observers must get their filtered changes in order, only through their executor and only while subscribed
+bool check_observers()
+{
+    const InternedString type_name("ObserverType");
+    const InternedString watched("WatchedTopic");
+    const InternedString ignored("IgnoredTopic");
+    const GUID_t spokesman = make_participant_guid(0);
+    const GUID_t ptid = make_participant_guid(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    // the executor only queues, the batches are delivered when the tasks are run below
+    std::mutex mutex;
+    std::vector<std::function<void()>> tasks;
+    std::vector<JournalEntry> received;
+    bool lost = false;
+
+    auto run_tasks = [&]()
+            {
+                std::vector<std::function<void()>> pending;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pending.swap(tasks);
+                }
+
+                for (std::function<void()>& task : pending)
+                {
+                    task();
+                }
+
+                return pending.size();
+            };
+
+    ObserverFilter filter;
+    filter.topics.push_back(watched);
+
+    ObserverId id = database.Subscribe(filter, [&](const DiscoveryChanges& changes)
+                    {
+                        lost |= changes.lost;
+                        received.insert(received.end(), changes.entries.begin(), changes.entries.end());
+                    }, [&](std::function<void()> task)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        tasks.push_back(std::move(task));
+                    });
+
+    database.AddParticipant(spokesman, "tests", ptid, "observed", now);
+
+    for (uint32_t i = 1; i <= 10; ++i)
+    {
+        database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, i), type_name,
+                i % 2 ? watched : ignored, now);
+    }
+
+    database.RemoveDataWriter(spokesman, ptid, make_endpoint_guid(ptid, 1));
+
+    // the notifier thread may have handed some batches already, the dispatch hands the rest
+    database.DispatchChanges();
+
+    if (!received.empty() || run_tasks() == 0)
+    {
+        std::cerr << "Observer called outside its executor" << std::endl;
+        return false;
+    }
+
+    // no batch is handed over once unsubscribed
+    database.Unsubscribe(id);
+    database.RemoveDataWriter(spokesman, ptid, make_endpoint_guid(ptid, 3));
+    database.DispatchChanges();
+
+    if (run_tasks() != 0 || received.size() != 6 || lost)
+    {
+        std::cerr << "Observer received " << received.size() << " changes" << std::endl;
+        return false;
+    }
+
+    for (std::size_t i = 0; i < received.size(); ++i)
+    {
+        if (received[i].topic_name != watched || (i > 0 && received[i].sequence <= received[i - 1].sequence))
+        {
+            std::cerr << "Unexpected observed change " << received[i] << std::endl;
+            return false;
+        }
+    }
+
+    return received.back().kind == JournalEntry::Kind::REMOVE_DATAWRITER;
+}
+
+std::string read_file(
+        const std::string& file)
+{
+    std::ifstream in(file, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+//! binary snapshots must be walked in place without allocations and convert back without losses
+bool check_binary_snapshots()
+{
+    const std::string file("database_tests_binary.dssnap");
+    const std::string copy("database_tests_binary_copy.dssnap");
+    const InternedString type_name("BinaryType");
+    const InternedString topic_name("BinaryTopic");
+    const GUID_t spokesman = make_participant_guid(0);
+    const uint32_t participants = 50;
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    database.AddParticipant(spokesman, "tests", spokesman, "spokesman", now);
+
+    for (uint32_t i = 1; i <= participants; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.AddParticipant(spokesman, "tests", ptid, "binary_" + std::to_string(i), now);
+        database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, topic_name, now);
+        database.AddDataReader(spokesman, "tests", ptid, make_endpoint_guid(ptid, 2), type_name, topic_name, now);
+    }
+
+    database.AddDataReader(spokesman, "tests", spokesman, make_endpoint_guid(spokesman, 2), type_name,
+            topic_name, now);
+    database.UpdateSubLiveliness(make_endpoint_guid(spokesman, 2), 3, 1);
+    database.RemoveParticipant(spokesman, make_participant_guid(participants)); // a zombie
+
+    std::vector<Snapshot> shots(1, database.GetState());
+    shots.back()._des = "binary check";
+    shots.back().show_liveliness_ = true;
+
+    if (!SaveBinarySnapshots(file, shots))
+    {
+        std::cerr << "Couldn't save " << file << std::endl;
+        return false;
+    }
+
+    BinarySnapshotFile mapping(file);
+
+    if (!mapping.Valid() || mapping.Snapshots().size() != 1)
+    {
+        std::cerr << "Couldn't map " << file << std::endl;
+        return false;
+    }
+
+    // walk every record
+    uint64_t allocations = heap_allocations();
+    std::size_t items = 0, endpoints = 0, alive = 0;
+
+    for (const snapshot_binary::SnapshotRecord& sh : mapping.Snapshots())
+    {
+        for (const snapshot_binary::DatabaseRecord& db : mapping.Databases(sh))
+        {
+            for (const snapshot_binary::ItemRecord& item : mapping.Items(db))
+            {
+                ++items;
+                endpoints += mapping.Readers(item).size() + mapping.Writers(item).size();
+                alive += mapping.String(item.name)[0] != '\0' && item.alive;
+            }
+        }
+    }
+
+    allocations = heap_allocations() - allocations;
+
+    // converting back and saving again must reproduce the file
+    std::vector<Snapshot> loaded(1, mapping.ToSnapshot(mapping.Snapshots()[0]));
+
+    bool res = allocations == 0 && items == participants + 1 && endpoints == 2 * participants + 1
+            && alive == participants && SaveBinarySnapshots(copy, loaded) && read_file(file) == read_file(copy)
+            && loaded.back().show_liveliness_ && loaded.back()._des == shots.back()._des
+            && loaded.back().size() == shots.back().size();
+
+    std::cout << "binary snapshot: " << read_file(file).size() << " bytes, " << items << " items, " << endpoints
+              << " endpoints, " << allocations << " allocations walking" << std::endl;
+
+    // a truncated file must be rejected
+    {
+        std::string content = read_file(file);
+        std::ofstream(copy, std::ios::binary | std::ios::trunc).write(content.data(), content.size() - 8);
+    }
+    res = res && !BinarySnapshotFile(copy).Valid();
+
+    std::remove(file.c_str());
+    std::remove(copy.c_str());
+
+    return res;
+}
+
+//! the streaming writer must reproduce the tinyxml2 output of the snapshot document
+bool check_streaming_xml()
+{
+    const InternedString type_name("Streaming<Type>");
+    const InternedString topic_name("Streaming & \"quoted\" 'topic'");
+    const GUID_t spokesman = make_participant_guid(0);
+    const GUID_t ptid = make_participant_guid(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+
+    database.AddParticipant(spokesman, "tests", spokesman, "spokesman", now);
+    database.AddParticipant(spokesman, "tests", ptid, "<streaming> & co", now);
+    database.AddParticipant(spokesman, "tests", make_participant_guid(2), "endpointless", now);
+    database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, topic_name, now);
+    database.AddDataReader(spokesman, "tests", spokesman, make_endpoint_guid(spokesman, 2), type_name,
+            topic_name, now);
+    database.UpdateSubLiveliness(make_endpoint_guid(spokesman, 2), 2, 1);
+
+    std::vector<Snapshot> shots(1, database.GetState());
+    shots.back()._des = "a <described> & \"quoted\" snapshot";
+    shots.back().show_liveliness_ = true;
+    shots.emplace_back(); // empty one
+
+    // document built as the manager did before streaming
+    tinyxml2::XMLDocument doc;
+    doc.InsertFirstChild(doc.NewDeclaration(nullptr));
+    tinyxml2::XMLElement* root = doc.NewElement("DS_Snapshots");
+    root->SetAttribute("xmlns", "http://www.eprosima.com/XMLSchemas/ds-snapshot");
+
+    for (const Snapshot& sh : shots)
+    {
+        tinyxml2::XMLElement* element = doc.NewElement("DS_Snapshot");
+        sh.to_xml(element, doc);
+        root->InsertEndChild(element);
+    }
+
+    doc.InsertEndChild(root);
+    tinyxml2::XMLPrinter printer;
+    doc.Print(&printer);
+
+    std::ostringstream streamed;
+    SnapshotXmlWriter writer(streamed);
+    writer.Begin();
+
+    for (const Snapshot& sh : shots)
+    {
+        writer.Write(sh);
+    }
+
+    writer.End();
+
+    if (streamed.str() != printer.CStr())
+    {
+        std::cerr << "Streamed:" << std::endl << streamed.str() << "tinyxml2:" << std::endl << printer.CStr();
+        return false;
+    }
+
+    return true;
+}
+
+std::string stream_snapshots(
+        const std::vector<Snapshot>& shots,
+        bool normalized = false)
+{
+    std::ostringstream out;
+    SnapshotXmlWriter writer(out, normalized);
+    writer.Begin();
+
+    for (const Snapshot& sh : shots)
+    {
+        writer.Write(sh);
+    }
+
+    writer.End();
+    return out.str();
+}
+
+//! the event driven loader must rebuild the written snapshots and only build the requested ones
+bool check_sax_loader()
+{
+    const InternedString type_name("Sax<Type>");
+    const InternedString topic_name("Sax & 'topic'");
+    const GUID_t spokesman = make_participant_guid(0);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+    database.AddParticipant(spokesman, "tests", spokesman, "spokesman", now);
+    database.AddDataReader(spokesman, "tests", spokesman, make_endpoint_guid(spokesman, 2), type_name,
+            topic_name, now);
+    database.UpdateSubLiveliness(make_endpoint_guid(spokesman, 2), 4, 2);
+
+    for (uint32_t i = 1; i <= 20; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.AddParticipant(spokesman, "tests", ptid, "sax_" + std::to_string(i), now);
+        database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, topic_name, now);
+    }
+
+    std::vector<Snapshot> shots(3, database.GetState());
+    shots[0]._des = "first <one>";
+    shots[0].show_liveliness_ = true;
+    shots[1]._des = "second";
+    shots[2]._des = "third & last";
+    shots[2].if_someone = false;
+
+    const std::string xml = stream_snapshots(shots);
+
+    std::vector<Snapshot> all;
+    SnapshotXmlReader reader;
+    std::istringstream in(xml);
+
+    if (!reader.Load(in, all) || stream_snapshots(all) != xml)
+    {
+        std::cerr << "SAX loader round trip failed: " << reader.Error() << std::endl;
+        return false;
+    }
+
+    // only the second one is built
+    std::vector<Snapshot> some;
+    SnapshotXmlReader filtered([](const std::string& description)
+            {
+                return description == "second";
+            });
+    std::istringstream in_filtered(xml);
+
+    if (!filtered.Load(in_filtered, some) || some.size() != 1 || filtered.Skipped() != 2
+            || stream_snapshots(some) != stream_snapshots(std::vector<Snapshot>(1, shots[1])))
+    {
+        std::cerr << "SAX loader filter failed" << std::endl;
+        return false;
+    }
+
+    // markup the writer never produces
+    std::vector<Snapshot> hand;
+    std::istringstream in_hand(
+        "<?xml version='1.0'?>\n<!-- comment -->\n<DS_Snapshots>"
+        "<DS_Snapshot timestamp='0' process_time='5' last_pdp_callback_time='1' last_edp_callback_time='2'>"
+        "<description><![CDATA[a <raw>]]> &#x41;&#66;</description><!-- inner -->"
+        "<ptdb guid_prefix='44.00.00.00.00.00.00.00.00.00.00.00' guid_entity='0.0.1.c1'>"
+        "<ptdi guid_prefix='44.00.00.00.00.00.00.00.00.00.00.01' guid_entity='0.0.1.c1' server='1' alive='false'"
+        " name='n' discovered_timestamp='3'><unknown/></ptdi></ptdb></DS_Snapshot></DS_Snapshots>");
+    std::istringstream in_bad("<DS_Snapshots><DS_Snapshot></DS_Snapshots>");
+    std::istringstream in_wrong("<DS><DS_Snapshot/></DS>");
+
+    if (!reader.Load(in_hand, hand) || hand.size() != 1 || hand[0]._des != "a <raw> AB" || hand[0].size() != 1
+            || !hand[0].begin()->begin()->is_server || hand[0].begin()->begin()->is_alive
+            || reader.Load(in_bad, hand) || reader.Load(in_wrong, hand))
+    {
+        std::cerr << "SAX loader markup failed: " << reader.Error() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+//! every guid in the snapshots, in file order
+std::vector<GUID_t> collect_guids(
+        const std::vector<Snapshot>& shots)
+{
+    std::vector<GUID_t> guids;
+
+    for (const Snapshot& sh : shots)
+    {
+        for (const ParticipantDiscoveryDatabase& discovery_database : sh)
+        {
+            guids.push_back(discovery_database.endpoint_guid);
+
+            for (const ParticipantDiscoveryItem& discovery_item : discovery_database)
+            {
+                guids.push_back(discovery_item.endpoint_guid);
+
+                for (const DataReaderDiscoveryItem& sub : discovery_item.getDataReaders())
+                {
+                    guids.push_back(sub.endpoint_guid);
+                }
+
+                for (const DataWriterDiscoveryItem& pub : discovery_item.getDataWriters())
+                {
+                    guids.push_back(pub.endpoint_guid);
+                }
+            }
+        }
+    }
+
+    return guids;
+}
+
+//! the codec and the fastdds stream operators must agree on the text and on what is rejected
+template<class Id>
+bool same_as_streams(
+        const char* text)
+{
+    Id streamed;
+    bool stream_ok = static_cast<bool>(std::istringstream(text) >> streamed);
+    Id decoded;
+    bool codec_ok = guid_codec::Decode(text, decoded);
+    return stream_ok == codec_ok && streamed == decoded;
+}
+
+//! encodes and decodes the snapshot guids with the codec and with the fastdds stream operators
+bool check_guid_codec(
+        const std::string& file)
+{
+    std::vector<Snapshot> shots;
+    SnapshotXmlReader reader;
+
+    if (!reader.Load(file, shots))
+    {
+        std::cerr << "Cannot load " << file << ": " << reader.Error() << std::endl;
+        return false;
+    }
+
+    const std::vector<GUID_t> guids = collect_guids(shots);
+    char prefix_text[guid_codec::prefix_size];
+    char entity_text[guid_codec::entity_size];
+
+    for (const GUID_t& guid : guids)
+    {
+        std::ostringstream prefix_stream;
+        prefix_stream << guid.guidPrefix;
+        std::ostringstream entity_stream;
+        entity_stream << guid.entityId;
+
+        GUID_t decoded;
+
+        if (guid_codec::Encode(guid.guidPrefix, prefix_text) != prefix_stream.str().size()
+                || prefix_stream.str() != prefix_text
+                || guid_codec::Encode(guid.entityId, entity_text) != entity_stream.str().size()
+                || entity_stream.str() != entity_text
+                || !guid_codec::Decode(prefix_text, decoded.guidPrefix)
+                || !guid_codec::Decode(entity_text, decoded.entityId)
+                || decoded != guid)
+        {
+            std::cerr << "GUID codec mismatch on " << guid << std::endl;
+            return false;
+        }
+    }
+
+    for (const char* text : {"44.53.00.5f.45.50.52.4f.53.49.4d.41", " 1.2.3.4.5.6.7.8.9.a.B.c",
+                             "01 . 002.3.4.5.6.7.8.9.a.b.0ff", "1.2.3.4.5.6.7.8.9.a.b", "1.2.3.4.5.6.7.8.9.a.b.100",
+                             "1.2.3.4.5.6.7.8.9.a.b.c.d", "1-2", ""})
+    {
+        if (!same_as_streams<GuidPrefix_t>(text))
+        {
+            std::cerr << "GUID codec parses prefix '" << text << "' unlike fastdds" << std::endl;
+            return false;
+        }
+    }
+
+    for (const char* text : {"0.0.1.c1", "0.0.01.C1 trailing", "\t0.0.1. c1", "0.0.1", "0..1.c1", "0.0.1.1c1", "x"})
+    {
+        if (!same_as_streams<EntityId_t>(text))
+        {
+            std::cerr << "GUID codec parses entity '" << text << "' unlike fastdds" << std::endl;
+            return false;
+        }
+    }
+
+    // the codec replaced a stream per id, it must not allocate
+    uint64_t allocations = heap_allocations();
+
+    for (const GUID_t& guid : guids)
+    {
+        guid_codec::Encode(guid.guidPrefix, prefix_text);
+        guid_codec::Encode(guid.entityId, entity_text);
+
+        GUID_t decoded;
+        guid_codec::Decode(prefix_text, decoded.guidPrefix);
+        guid_codec::Decode(entity_text, decoded.entityId);
+    }
+
+    allocations = heap_allocations() - allocations;
+
+    std::cout << guids.size() << " snapshot guids: " << allocations << " allocations on the codec round trip"
+              << std::endl;
+
+    return allocations == 0;
+}
+
+//! normalized files must load back the same snapshots and shrink as the spokesmen share participants
+bool check_normalized_snapshots(
+        const std::string& file)
+{
+    std::vector<Snapshot> shots;
+    SnapshotXmlReader reader;
+
+    if (!reader.Load(file, shots))
+    {
+        std::cerr << "Cannot load " << file << ": " << reader.Error() << std::endl;
+        return false;
+    }
+
+    // two spokesmen sharing participants, names only known by one and liveliness on its own readers
+    const InternedString type_name("Normalized<Type>");
+    const GUID_t spokesman = make_participant_guid(0);
+    const GUID_t other = make_participant_guid(1);
+    const auto now = std::chrono::steady_clock::now();
+
+    DiscoveryItemDatabase database;
+    database.AddParticipant(spokesman, "tests", spokesman, "spokesman", now);
+    database.AddParticipant(other, "tests", other, "other", now);
+    database.AddDataReader(spokesman, "tests", spokesman, make_endpoint_guid(spokesman, 2), type_name,
+            "topic", now);
+    database.UpdateSubLiveliness(make_endpoint_guid(spokesman, 2), 3, 1);
+
+    for (uint32_t i = 2; i <= 20; ++i)
+    {
+        GUID_t ptid = make_participant_guid(i);
+        database.AddParticipant(spokesman, "tests", ptid, "normalized_" + std::to_string(i), now);
+        database.AddParticipant(other, "tests", ptid, "", now + std::chrono::milliseconds(i));
+        database.AddDataWriter(spokesman, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, "topic", now);
+        database.AddDataWriter(other, "tests", ptid, make_endpoint_guid(ptid, 1), type_name, "topic",
+                now + std::chrono::milliseconds(i));
+    }
+
+    shots.push_back(database.GetState());
+    shots.back()._des = "normalized";
+    shots.back().show_liveliness_ = true;
+
+    const std::string xml = stream_snapshots(shots);
+    const std::string normalized = stream_snapshots(shots, true);
+
+    std::vector<Snapshot> loaded;
+    std::istringstream in(normalized);
+
+    if (!reader.Load(in, loaded) || stream_snapshots(loaded) != xml)
+    {
+        std::cerr << "Normalized snapshots round trip failed: " << reader.Error() << std::endl;
+        return false;
+    }
+
+    std::cout << "normalized snapshot: " << normalized.size() << " bytes, "
+              << xml.size() << " bytes as ptdb copies" << std::endl;
+
+    // overrides of the rows and references to missing rows, as a hand edited file may have
+    std::vector<Snapshot> hand;
+    std::istringstream in_hand(
+        "<DS_Snapshots><DS_Snapshot timestamp='0' process_time='5' last_pdp_callback_time='1'"
+        " last_edp_callback_time='2'><description>hand</description><participants>"
+        "<participant id='7' guid_prefix='44.0.0.0.0.0.0.0.0.0.0.1' guid_entity='0.0.1.c1' server='true' name='p'>"
+        "<publisher id='3' guid_entity='0.0.1.3' type='t' topic='a'/></participant></participants>"
+        "<ptdb guid_prefix='44.0.0.0.0.0.0.0.0.0.0.0' guid_entity='0.0.1.c1'>"
+        "<participant_ref id='7' alive='false' name='q' discovered_timestamp='3'>"
+        "<publisher_ref id='3' topic='b' discovered_timestamp='4'/><subscriber_ref id='3'/>"
+        "<publisher_ref id='9'/></participant_ref><participant_ref id='8'/></ptdb>"
+        "</DS_Snapshot></DS_Snapshots>");
+
+    if (!reader.Load(in_hand, hand) || hand.size() != 1 || hand[0].size() != 1 || hand[0].begin()->size() != 1)
+    {
+        std::cerr << "Normalized snapshot markup failed: " << reader.Error() << std::endl;
+        return false;
+    }
+
+    const ParticipantDiscoveryItem& item = *hand[0].begin()->begin();
+
+    if (!item.is_server || item.is_alive || item.participant_name != "q" || item.getDataReaders().size() != 0
+            || item.getDataWriters().size() != 1
+            || item.getDataWriters().begin()->endpoint_guid.guidPrefix != item.endpoint_guid.guidPrefix
+            || item.getDataWriters().begin()->type_name != InternedString("t")
+            || item.getDataWriters().begin()->topic_name != InternedString("b"))
+    {
+        std::cerr << "Normalized snapshot overrides failed" << std::endl;
+        return false;
+    }
+
+    return normalized.size() < xml.size();
+}
+
+//! a named check, the reference snapshot is only used by some
+struct Check
+{
+    const char* name;
+    bool (* run)(const std::string& snapshot);
+};
+
+const Check s_checks[] = {
+    {"topic_queries", [](const std::string&)
+     {
+         return check_topic_queries();
+     }},
+    {"ingestion_allocations", [](const std::string&)
+     {
+         return check_ingestion_allocations();
+     }},
+    {"copy_on_write", [](const std::string&)
+     {
+         return check_copy_on_write();
+     }},
+    {"concurrent_indexes", [](const std::string&)
+     {
+         return check_concurrent_indexes();
+     }},
+    {"zombie_reaper", [](const std::string&)
+     {
+         return check_zombie_reaper();
+     }},
+    {"counters", [](const std::string&)
+     {
+         return check_counters();
+     }},
+    {"journal", [](const std::string&)
+     {
+         return check_journal();
+     }},
+    {"observers", [](const std::string&)
+     {
+         return check_observers();
+     }},
+    {"binary_snapshots", [](const std::string&)
+     {
+         return check_binary_snapshots();
+     }},
+    {"streaming_xml", [](const std::string&)
+     {
+         return check_streaming_xml();
+     }},
+    {"sax_loader", [](const std::string&)
+     {
+         return check_sax_loader();
+     }},
+    {"guid_codec", check_guid_codec},
+    {"normalized_snapshots", check_normalized_snapshots},
+};
+
+} // namespace
+
+// runs the named check, each one is a ctest entry
+int main(
+        int argc,
+        char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <check> [reference snapshot]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const std::string snapshot = argc > 2 ? argv[2] : std::string();
+
+    for (const Check& check : s_checks)
+    {
+        if (std::strcmp(check.name, argv[1]) == 0)
+        {
+            if (!check.run(snapshot))
+            {
+                std::cerr << "Check " << check.name << " failed" << std::endl;
+                return EXIT_FAILURE;
+            }
+
+            return EXIT_SUCCESS;
+        }
+    }
+
+    std::cerr << "Unknown check " << argv[1] << std::endl;
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,92 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "TestHelpers.h"
+
+namespace {
+
+//! heap allocations performed by the process
+std::atomic<uint64_t> s_heap_allocations(0);
+
+void* counted_allocation(
+        std::size_t size)
+{
+    ++s_heap_allocations;
+
+    if (void* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+} // namespace
+
+namespace eprosima {
+namespace discovery_server {
+namespace testing {
+
+uint64_t heap_allocations()
+{
+    return s_heap_allocations;
+}
+
+} // namespace testing
+} // namespace discovery_server
+} // namespace eprosima
+
+// the scalar and array forms are replaced together so every new is released by its matching delete
+
+void* operator new(
+        std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void* operator new[](
+        std::size_t size)
+{
+    return counted_allocation(size);
+}
+
+void operator delete(
+        void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](
+        void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(
+        void* p,
+        std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](
+        void* p,
+        std::size_t) noexcept
+{
+    std::free(p);
+}
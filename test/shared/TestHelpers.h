@@ -0,0 +1,55 @@
+// Copyright 2026 Proyectos y Sistemas de Mantenimiento SL (eProsima).
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef _TEST_HELPERS_H_
+#define _TEST_HELPERS_H_
+
+#include <cstdint>
+
+#include <fastdds/rtps/common/Guid.hpp>
+
+namespace eprosima {
+namespace discovery_server {
+namespace testing {
+
+//! heap allocations performed by the process, counted by the operator new replacement in TestHelpers.cpp
+uint64_t heap_allocations();
+
+//! participant guid made unique by its index
+inline fastdds::rtps::GUID_t make_participant_guid(
+        uint32_t index)
+{
+    fastdds::rtps::GUID_t guid;
+    guid.guidPrefix.value[0] = 0x44;
+    guid.guidPrefix.value[8] = static_cast<fastdds::rtps::octet>(index >> 24);
+    guid.guidPrefix.value[9] = static_cast<fastdds::rtps::octet>(index >> 16);
+    guid.guidPrefix.value[10] = static_cast<fastdds::rtps::octet>(index >> 8);
+    guid.guidPrefix.value[11] = static_cast<fastdds::rtps::octet>(index);
+    guid.entityId = fastdds::rtps::c_EntityId_RTPSParticipant;
+    return guid;
+}
+
+//! endpoint guid of the participant made unique by its key
+inline fastdds::rtps::GUID_t make_endpoint_guid(
+        const fastdds::rtps::GUID_t& participant,
+        uint32_t key)
+{
+    return fastdds::rtps::GUID_t(participant.guidPrefix, fastdds::rtps::EntityId_t((key << 8) | 0x03));
+}
+
+} // namespace testing
+} // namespace discovery_server
+} // namespace eprosima
+
+#endif // _TEST_HELPERS_H_
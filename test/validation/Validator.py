@@ -102,8 +102,120 @@ class Validator(object):
         with open(xml_file_path) as xml_file:
             snapshot_dict = xmltodict.parse(xml_file.read())
 
+        return self.expand_normalized_snapshot(snapshot_dict)
+
+    def expand_normalized_snapshot(
+        self,
+        snapshot_dict
+    ):
+        """
+        Expand the snapshots in the normalized encoding into ptdb copies.
+
+        The normalized encoding lists each participant and endpoint once in
+        a participants table and the ptdb elements only reference its rows.
+        The expanded dictionary is the one the classic encoding of the same
+        snapshots is parsed into, so the validators compare both alike.
+
+        :param snapshot_dict: The parsed snapshot dictionary.
+
+        :return: snapshot dictionary without participants tables.
+        """
+        try:
+            snapshots = snapshot_dict['DS_Snapshots']['DS_Snapshot']
+        except (KeyError, TypeError):
+            return snapshot_dict
+
+        for snapshot in self.__dict2list(snapshots):
+            if (not isinstance(snapshot, dict) or
+                    'participants' not in snapshot):
+                continue
+
+            participants = {}
+            endpoints = {}
+            table = snapshot.pop('participants') or {}
+            for row in self.__dict2list(table.get('participant', [])):
+                participants[row['@id']] = row
+                for kind in ('subscriber', 'publisher'):
+                    for endpoint in self.__dict2list(row.get(kind, [])):
+                        endpoints[endpoint['@id']] = (kind, row, endpoint)
+
+            for ptdb in self.__dict2list(snapshot.get('ptdb', [])):
+                if not isinstance(ptdb, dict) or 'participant_ref' not in ptdb:
+                    continue
+
+                ptdi_l = []
+                for ref in self.__dict2list(ptdb.pop('participant_ref')):
+                    row = participants.get(ref['@id'])
+                    if row is None:
+                        self.logger.debug(
+                            f"Participant reference {ref['@id']} "
+                            'without table row ignored.')
+                        continue
+
+                    ptdi = {
+                        '@guid_prefix': row['@guid_prefix'],
+                        '@guid_entity': row['@guid_entity'],
+                        '@server': ref.get('@server', row['@server']),
+                        '@alive': ref.get('@alive', row['@alive']),
+                        '@name': ref.get('@name', row['@name']),
+                        '@discovered_timestamp': ref['@discovered_timestamp']}
+
+                    for kind in ('subscriber', 'publisher'):
+                        endpoint_l = []
+                        for endpoint_ref in self.__dict2list(
+                                ref.get(f'{kind}_ref', [])):
+                            row_kind, owner, endpoint = endpoints.get(
+                                endpoint_ref['@id'], (None, None, None))
+                            if row_kind != kind:
+                                self.logger.debug(
+                                    f"{kind} reference {endpoint_ref['@id']} "
+                                    'without table row ignored.')
+                                continue
+
+                            item = {
+                                '@type': endpoint_ref.get(
+                                    '@type', endpoint['@type']),
+                                '@topic': endpoint_ref.get(
+                                    '@topic', endpoint['@topic']),
+                                '@guid_prefix': endpoint.get(
+                                    '@guid_prefix', owner['@guid_prefix']),
+                                '@guid_entity': endpoint['@guid_entity'],
+                                '@discovered_timestamp':
+                                    endpoint_ref['@discovered_timestamp']}
+                            for counter in ('@alive_count',
+                                            '@not_alive_count'):
+                                if counter in endpoint_ref:
+                                    item[counter] = endpoint_ref[counter]
+                            endpoint_l.append(item)
+
+                        if endpoint_l:
+                            ptdi[kind] = self.__list2dict(endpoint_l)
+
+                    ptdi_l.append(ptdi)
+
+                if ptdi_l:
+                    ptdb['ptdi'] = self.__list2dict(ptdi_l)
+
         return snapshot_dict
 
+    def __dict2list(self, d):
+        """
+        Cast an item from a dictionary to a list if it is not already one.
+
+        :param d: The dictionary item.
+        :return: The list with the dictionary items as elements of the list.
+        """
+        return d if isinstance(d, list) else [d]
+
+    def __list2dict(self, items):
+        """
+        Keep a single item as xmltodict parses a not repeated element.
+
+        :param items: The list of items.
+        :return: The only item or the list if there are several.
+        """
+        return items[0] if len(items) == 1 else items
+
     def validate(self):
         """General validation function.
 